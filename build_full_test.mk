@@ -27,6 +27,7 @@ $(TEST)_SRC := \
 	tests/test_common/test_fixture.cpp \
 	tests/test_common/test_keymap_key.cpp \
 	tests/test_common/test_logger.cpp \
+	tests/test_common/test_replay.cpp \
 	$(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
 
 $(TEST)_DEFS := $(TMK_COMMON_DEFS) $(OPT_DEFS)
@@ -31,6 +31,7 @@ GENERIC_FEATURES = \
     KEY_OVERRIDE \
     LEADER \
     PROGRAMMABLE_BUTTON \
+    SCAN_PROFILE \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
@@ -181,7 +181,12 @@ else
         OPT_DEFS += -DEEPROM_DRIVER
         COMMON_VPATH += $(DRIVER_PATH)/eeprom
         SRC += eeprom_driver.c
-        SRC += $(PLATFORM_COMMON_DIR)/eeprom_stm32.c
+        ifeq ($(strip $(EEPROM_PAGE_SWAPPING)), yes)
+          OPT_DEFS += -DFEE_PAGE_SWAPPING
+          SRC += $(PLATFORM_COMMON_DIR)/eeprom_stm32_swap.c
+        else
+          SRC += $(PLATFORM_COMMON_DIR)/eeprom_stm32.c
+        endif
         SRC += $(PLATFORM_COMMON_DIR)/flash_stm32.c
       else ifneq ($(filter $(MCU_SERIES),STM32L0xx STM32L1xx),)
         OPT_DEFS += -DEEPROM_DRIVER
@@ -201,6 +206,16 @@ else
   endif
 endif
 
+ifeq ($(strip $(EEPROM_WRITE_BACK_ENABLE)), yes)
+  # Only drivers built on eeprom_driver.c can be cached, custom ones provide the block functions it wraps
+  ifneq ($(filter -DEEPROM_DRIVER,$(OPT_DEFS)),)
+    ifeq ($(filter -DEEPROM_CUSTOM,$(OPT_DEFS)),)
+      OPT_DEFS += -DEEPROM_WRITE_BACK_ENABLE
+      DEFERRED_EXEC_ENABLE := yes
+    endif
+  endif
+endif
+
 RGBLIGHT_ENABLE ?= no
 VALID_RGBLIGHT_TYPES := WS2812 APA102 custom
 
@@ -405,7 +420,7 @@ ifeq ($(strip $(BACKLIGHT_ENABLE)), yes)
     endif
 endif
 
-VALID_WS2812_DRIVER_TYPES := bitbang pwm spi i2c
+VALID_WS2812_DRIVER_TYPES := bitbang pwm spi i2c gpio_dma
 
 WS2812_DRIVER ?= bitbang
 ifeq ($(strip $(WS2812_DRIVER_REQUIRED)), yes)
@@ -421,7 +436,7 @@ ifeq ($(strip $(WS2812_DRIVER_REQUIRED)), yes)
         SRC += ws2812_$(strip $(WS2812_DRIVER)).c
 
         ifeq ($(strip $(PLATFORM)), CHIBIOS)
-            ifeq ($(strip $(WS2812_DRIVER)), pwm)
+            ifneq ($(filter $(WS2812_DRIVER),pwm gpio_dma),)
                 OPT_DEFS += -DSTM32_DMA_REQUIRED=TRUE
             endif
         endif
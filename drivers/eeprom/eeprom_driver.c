@@ -19,35 +19,182 @@
 
 #include "eeprom_driver.h"
 
+#ifdef EEPROM_CUSTOM
+// Custom drivers implement eeprom_read_block() and eeprom_write_block() themselves
+#    define eeprom_driver_read_block eeprom_read_block
+#    define eeprom_driver_write_block eeprom_write_block
+#endif
+
+#ifdef EEPROM_WRITE_BACK_ENABLE
+#    include "deferred_exec.h"
+
+#    ifndef EEPROM_WRITE_BACK_RANGES
+#        define EEPROM_WRITE_BACK_RANGES 4
+#    endif
+#    ifndef EEPROM_WRITE_BACK_RANGE_SIZE
+#        define EEPROM_WRITE_BACK_RANGE_SIZE 32
+#    endif
+#    ifndef EEPROM_WRITE_BACK_TIMEOUT
+#        define EEPROM_WRITE_BACK_TIMEOUT 2000
+#    endif
+
+#    ifndef MIN
+#        define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#    endif
+#    ifndef MAX
+#        define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#    endif
+
+_Static_assert(EEPROM_WRITE_BACK_RANGE_SIZE <= UINT8_MAX, "EEPROM_WRITE_BACK_RANGE_SIZE must fit in a uint8_t");
+
+// A contiguous run of bytes which has been written, but not yet passed on to the driver.
+typedef struct {
+    uintptr_t addr;
+    uint8_t   len;
+    uint8_t   data[EEPROM_WRITE_BACK_RANGE_SIZE];
+} eeprom_dirty_range_t;
+
+static eeprom_dirty_range_t dirty_ranges[EEPROM_WRITE_BACK_RANGES];
+static deferred_token       flush_token = INVALID_DEFERRED_TOKEN;
+
+void eeprom_driver_flush(void) {
+    if (flush_token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec(flush_token);
+        flush_token = INVALID_DEFERRED_TOKEN;
+    }
+    for (int i = 0; i < EEPROM_WRITE_BACK_RANGES; ++i) {
+        eeprom_dirty_range_t *range = &dirty_ranges[i];
+        if (range->len) {
+            eeprom_driver_write_block(range->data, (void *)range->addr, range->len);
+            range->len = 0;
+        }
+    }
+}
+
+static uint32_t eeprom_flush_callback(uint32_t trigger_time, void *cb_arg) {
+    flush_token = INVALID_DEFERRED_TOKEN;
+    eeprom_driver_flush();
+    return 0;
+}
+
+// Reads from the driver, with any pending writes laid over the top.
+static void eeprom_cached_read(void *buf, const void *addr, size_t len) {
+    eeprom_driver_read_block(buf, addr, len);
+
+    uintptr_t start = (uintptr_t)addr;
+    uintptr_t end   = start + len;
+    for (int i = 0; i < EEPROM_WRITE_BACK_RANGES; ++i) {
+        eeprom_dirty_range_t *range = &dirty_ranges[i];
+        uintptr_t             lo    = MAX(start, range->addr);
+        uintptr_t             hi    = MIN(end, range->addr + range->len);
+        if (range->len && lo < hi) {
+            memcpy((uint8_t *)buf + (lo - start), &range->data[lo - range->addr], hi - lo);
+        }
+    }
+}
+
+// Records a write, merging it into an overlapping or adjacent range where possible, and (re)starts the idle timeout.
+static void eeprom_cached_write(const void *buf, void *addr, size_t len) {
+    uintptr_t start = (uintptr_t)addr;
+    uintptr_t end   = start + len;
+
+    if (len > EEPROM_WRITE_BACK_RANGE_SIZE) {
+        eeprom_driver_flush();
+        eeprom_driver_write_block(buf, addr, len);
+        return;
+    }
+
+    // Keep every range holding these bytes up to date, so they can be flushed in any order
+    bool                  covered = false;
+    eeprom_dirty_range_t *merge   = NULL;
+    eeprom_dirty_range_t *unused  = NULL;
+    for (int i = 0; i < EEPROM_WRITE_BACK_RANGES; ++i) {
+        eeprom_dirty_range_t *range = &dirty_ranges[i];
+        uintptr_t             lo    = MAX(start, range->addr);
+        uintptr_t             hi    = MIN(end, range->addr + range->len);
+        if (!range->len) {
+            if (!unused) unused = range;
+            continue;
+        }
+        if (lo < hi) {
+            memcpy(&range->data[lo - range->addr], (const uint8_t *)buf + (lo - start), hi - lo);
+        }
+        if (range->addr <= start && end <= range->addr + range->len) {
+            covered = true;
+        } else if (!merge && lo <= hi && MAX(end, range->addr + range->len) - MIN(start, range->addr) <= EEPROM_WRITE_BACK_RANGE_SIZE) {
+            merge = range;
+        }
+    }
+
+    if (!covered) {
+        if (merge) {
+            if (start < merge->addr) {
+                memmove(&merge->data[merge->addr - start], merge->data, merge->len);
+                merge->len += merge->addr - start;
+                merge->addr = start;
+            }
+            memcpy(&merge->data[start - merge->addr], buf, len);
+            merge->len = MAX(merge->len, end - merge->addr);
+        } else {
+            if (!unused) {
+                eeprom_driver_flush();
+                unused = &dirty_ranges[0];
+            }
+            unused->addr = start;
+            unused->len  = len;
+            memcpy(unused->data, buf, len);
+        }
+    }
+
+    if (flush_token == INVALID_DEFERRED_TOKEN || !extend_deferred_exec(flush_token, EEPROM_WRITE_BACK_TIMEOUT)) {
+        flush_token = defer_exec(EEPROM_WRITE_BACK_TIMEOUT, eeprom_flush_callback, NULL);
+        if (flush_token == INVALID_DEFERRED_TOKEN) {
+            eeprom_driver_flush();
+        }
+    }
+}
+#else
+#    define eeprom_cached_read eeprom_driver_read_block
+#    define eeprom_cached_write eeprom_driver_write_block
+
+void eeprom_driver_flush(void) {}
+#endif
+
+#ifndef EEPROM_CUSTOM
+void eeprom_read_block(void *buf, const void *addr, size_t len) { eeprom_cached_read(buf, addr, len); }
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) { eeprom_cached_write(buf, addr, len); }
+#endif
+
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uint8_t ret = 0;
-    eeprom_read_block(&ret, addr, 1);
+    eeprom_cached_read(&ret, addr, 1);
     return ret;
 }
 
 uint16_t eeprom_read_word(const uint16_t *addr) {
     uint16_t ret = 0;
-    eeprom_read_block(&ret, addr, 2);
+    eeprom_cached_read(&ret, addr, 2);
     return ret;
 }
 
 uint32_t eeprom_read_dword(const uint32_t *addr) {
     uint32_t ret = 0;
-    eeprom_read_block(&ret, addr, 4);
+    eeprom_cached_read(&ret, addr, 4);
     return ret;
 }
 
-void eeprom_write_byte(uint8_t *addr, uint8_t value) { eeprom_write_block(&value, addr, 1); }
+void eeprom_write_byte(uint8_t *addr, uint8_t value) { eeprom_cached_write(&value, addr, 1); }
 
-void eeprom_write_word(uint16_t *addr, uint16_t value) { eeprom_write_block(&value, addr, 2); }
+void eeprom_write_word(uint16_t *addr, uint16_t value) { eeprom_cached_write(&value, addr, 2); }
 
-void eeprom_write_dword(uint32_t *addr, uint32_t value) { eeprom_write_block(&value, addr, 4); }
+void eeprom_write_dword(uint32_t *addr, uint32_t value) { eeprom_cached_write(&value, addr, 4); }
 
 void eeprom_update_block(const void *buf, void *addr, size_t len) {
     uint8_t read_buf[len];
-    eeprom_read_block(read_buf, addr, len);
+    eeprom_cached_read(read_buf, addr, len);
     if (memcmp(buf, read_buf, len) != 0) {
-        eeprom_write_block(buf, addr, len);
+        eeprom_cached_write(buf, addr, len);
     }
 }
 
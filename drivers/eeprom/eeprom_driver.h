@@ -20,3 +20,13 @@
 
 void eeprom_driver_init(void);
 void eeprom_driver_erase(void);
+void eeprom_driver_flush(void);
+
+/* Raw block access, implemented by each driver. The eeprom_read_block() and
+ * eeprom_write_block() functions in eeprom_driver.c sit on top of these, so
+ * they also see writes still held by the write-back cache. */
+void eeprom_driver_read_block(void *buf, const void *addr, size_t len);
+void eeprom_driver_write_block(const void *buf, void *addr, size_t len);
+#ifdef FEE_PAGE_SWAPPING
+void eeprom_driver_task(void);
+#endif
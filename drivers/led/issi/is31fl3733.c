@@ -80,6 +80,10 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
 bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+#ifdef ISSI_PWM_DIRTY_TRACKING
+// One bit per 16 byte block of g_pwm_buffer, set when the block has changed since it was last sent.
+uint16_t g_pwm_buffer_dirty_blocks[DRIVER_COUNT] = {0};
+#endif
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -180,15 +184,31 @@ void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     wait_ms(10);
 }
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+static void IS31FL3733_set_pwm_register(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg]            = value;
+        g_pwm_buffer_dirty_blocks[driver] |= 1 << (reg / 16);
+        g_pwm_buffer_update_required[driver] = true;
+    }
+}
+#endif
+
 void IS31FL3733_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+        IS31FL3733_set_pwm_register(led.driver, led.r, red);
+        IS31FL3733_set_pwm_register(led.driver, led.g, green);
+        IS31FL3733_set_pwm_register(led.driver, led.b, blue);
+#else
         g_pwm_buffer[led.driver][led.r]          = red;
         g_pwm_buffer[led.driver][led.g]          = green;
         g_pwm_buffer[led.driver][led.b]          = blue;
         g_pwm_buffer_update_required[led.driver] = true;
+#endif
     }
 }
 
@@ -228,6 +248,37 @@ void IS31FL3733_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_led_control_registers_update_required[led.driver] = true;
 }
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+// Sends the blocks of the PWM buffer which have changed since they were last sent. Assumes the PWM page is already selected.
+// If any of the transactions fails, the remaining blocks stay dirty and the function returns false.
+static bool IS31FL3733_write_dirty_pwm_blocks(uint8_t addr, uint8_t index) {
+    for (uint8_t block = 0; block < 12; block++) {
+        if ((g_pwm_buffer_dirty_blocks[index] & (1 << block)) == 0) {
+            continue;
+        }
+
+        g_twi_transfer_buffer[0] = block * 16;
+        for (int j = 0; j < 16; j++) {
+            g_twi_transfer_buffer[1 + j] = g_pwm_buffer[index][block * 16 + j];
+        }
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
+                return false;
+            }
+        }
+#else
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+#endif
+        g_pwm_buffer_dirty_blocks[index] &= ~(1 << block);
+    }
+    return true;
+}
+#endif
+
 void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
         // Firstly we need to unlock the command register and select PG1.
@@ -236,11 +287,20 @@ void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
 
         // If any of the transactions fail we risk writing dirty PG0,
         // refresh page 0 just in case.
+#ifdef ISSI_PWM_DIRTY_TRACKING
+        if (!IS31FL3733_write_dirty_pwm_blocks(addr, index)) {
+#else
         if (!IS31FL3733_write_pwm_buffer(addr, g_pwm_buffer[index])) {
+#endif
             g_led_control_registers_update_required[index] = true;
         }
     }
+#ifdef ISSI_PWM_DIRTY_TRACKING
+    // Blocks which failed to send are retried on the next flush
+    g_pwm_buffer_update_required[index] = g_pwm_buffer_dirty_blocks[index] != 0;
+#else
     g_pwm_buffer_update_required[index] = false;
+#endif
 }
 
 void IS31FL3733_update_led_control_registers(uint8_t addr, uint8_t index) {
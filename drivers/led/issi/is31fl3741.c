@@ -82,6 +82,11 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
 bool    g_pwm_buffer_update_required[DRIVER_COUNT]        = {false};
+#ifdef ISSI_PWM_DIRTY_TRACKING
+// One bit per 18 byte block of g_pwm_buffer (the last block holds the remaining 9 bytes),
+// set when the block has changed since it was last sent.
+uint32_t g_pwm_buffer_dirty_blocks[DRIVER_COUNT] = {0};
+#endif
 bool    g_scaling_registers_update_required[DRIVER_COUNT] = {false};
 
 uint8_t g_scaling_registers[DRIVER_COUNT][ISSI_MAX_LEDS];
@@ -173,15 +178,31 @@ void IS31FL3741_init(uint8_t addr) {
     wait_ms(10);
 }
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+static void IS31FL3741_set_pwm_register(uint8_t driver, uint16_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg]            = value;
+        g_pwm_buffer_dirty_blocks[driver] |= (uint32_t)1 << (reg / 18);
+        g_pwm_buffer_update_required[driver] = true;
+    }
+}
+#endif
+
 void IS31FL3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+        IS31FL3741_set_pwm_register(led.driver, led.r, red);
+        IS31FL3741_set_pwm_register(led.driver, led.g, green);
+        IS31FL3741_set_pwm_register(led.driver, led.b, blue);
+#else
         g_pwm_buffer[led.driver][led.r]          = red;
         g_pwm_buffer[led.driver][led.g]          = green;
         g_pwm_buffer[led.driver][led.b]          = blue;
         g_pwm_buffer_update_required[led.driver] = true;
+#endif
     }
 }
 
@@ -216,20 +237,78 @@ void IS31FL3741_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_scaling_registers_update_required[led.driver] = true;
 }
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+// Sends the blocks of the PWM buffer which have changed since they were last sent, selecting
+// each PWM page only when it holds a dirty block.
+// If any of the transactions fails, the remaining blocks stay dirty and the function returns false.
+static bool IS31FL3741_write_dirty_pwm_blocks(uint8_t addr, uint8_t index) {
+    uint8_t page = 0xFF;
+
+    for (uint8_t block = 0; block < 20; block++) {
+        if ((g_pwm_buffer_dirty_blocks[index] & ((uint32_t)1 << block)) == 0) {
+            continue;
+        }
+
+        // the first 180 bytes are on PG0, the rest on PG1
+        uint8_t block_page = block < 10 ? ISSI_PAGE_PWM0 : ISSI_PAGE_PWM1;
+        if (page != block_page) {
+            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
+            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, block_page);
+            page = block_page;
+        }
+
+        uint16_t offset = block * 18;
+        uint8_t  length = block < 19 ? 18 : ISSI_MAX_LEDS - offset;
+
+        g_twi_transfer_buffer[0] = offset % 180;
+        memcpy(g_twi_transfer_buffer + 1, g_pwm_buffer[index] + offset, length);
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+                return false;
+            }
+        }
+#else
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+#endif
+        g_pwm_buffer_dirty_blocks[index] &= ~((uint32_t)1 << block);
+    }
+    return true;
+}
+#endif
+
 void IS31FL3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
+#ifdef ISSI_PWM_DIRTY_TRACKING
+        IS31FL3741_write_dirty_pwm_blocks(addr, index);
+#else
         IS31FL3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+#endif
     }
 
+#ifdef ISSI_PWM_DIRTY_TRACKING
+    // Blocks which failed to send are retried on the next flush
+    g_pwm_buffer_update_required[index] = g_pwm_buffer_dirty_blocks[index] != 0;
+#else
     g_pwm_buffer_update_required[index] = false;
+#endif
 }
 
 void IS31FL3741_set_pwm_buffer(const is31_led *pled, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef ISSI_PWM_DIRTY_TRACKING
+    IS31FL3741_set_pwm_register(pled->driver, pled->r, red);
+    IS31FL3741_set_pwm_register(pled->driver, pled->g, green);
+    IS31FL3741_set_pwm_register(pled->driver, pled->b, blue);
+#else
     g_pwm_buffer[pled->driver][pled->r] = red;
     g_pwm_buffer[pled->driver][pled->g] = green;
     g_pwm_buffer[pled->driver][pled->b] = blue;
 
     g_pwm_buffer_update_required[pled->driver] = true;
+#endif
 }
 
 void IS31FL3741_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -82,6 +82,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // Charge Pump Commands
 #define CHARGE_PUMP 0x8D
 
+#ifdef OLED_ASYNC_RENDER
+#    ifndef PROTOCOL_CHIBIOS
+#        error "OLED_ASYNC_RENDER is only supported on ChibiOS"
+#    endif
+#    include <ch.h>
+#    ifndef OLED_ASYNC_RENDER_FPS
+#        define OLED_ASYNC_RENDER_FPS 30
+#    endif
+#    ifndef OLED_ASYNC_RENDER_STACK_SIZE
+#        define OLED_ASYNC_RENDER_STACK_SIZE 256
+#    endif
+static void oled_render_async_init(void);
+static void oled_render_wait(void);
+#endif
+
 // Misc defines
 #ifndef OLED_BLOCK_COUNT
 #    define OLED_BLOCK_COUNT (sizeof(OLED_BLOCK_TYPE) * 8)
@@ -97,10 +112,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define I2C_DATA 0x40
 #if defined(__AVR__)
 #    define I2C_TRANSMIT_P(data) i2c_transmit_P((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
+#elif defined(OLED_ASYNC_RENDER)
+#    define I2C_TRANSMIT_P(data) (oled_render_wait(), i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT))
 #else  // defined(__AVR__)
 #    define I2C_TRANSMIT_P(data) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
 #endif  // defined(__AVR__)
-#define I2C_TRANSMIT(data) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
+#if defined(OLED_ASYNC_RENDER)
+#    define I2C_TRANSMIT(data) (oled_render_wait(), i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT))
+#else
+#    define I2C_TRANSMIT(data) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
+#endif
 #define I2C_WRITE_REG(mode, data, size) i2c_writeReg((OLED_DISPLAY_ADDRESS << 1), mode, data, size, OLED_I2C_TIMEOUT)
 
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
@@ -229,6 +250,9 @@ bool oled_init(oled_rotation_t rotation) {
     oled_initialized = true;
     oled_active      = true;
     oled_scrolling   = false;
+#ifdef OLED_ASYNC_RENDER
+    oled_render_async_init();
+#endif
     return true;
 }
 
@@ -286,23 +310,16 @@ static void rotate_90(const uint8_t *src, uint8_t *dest) {
     }
 }
 
-void oled_render(void) {
-    if (!oled_initialized) {
-        return;
-    }
-
-    // Do we have work to do?
-    oled_dirty &= OLED_ALL_BLOCKS_MASK;
-    if (!oled_dirty || oled_scrolling) {
-        return;
-    }
-
-    // Find first dirty block
-    uint8_t update_start = 0;
-    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
-        ++update_start;
-    }
+typedef enum {
+    OLED_RENDER_OK,
+    OLED_RENDER_OFFSET_FAILED,
+    OLED_RENDER_DATA_FAILED,
+    OLED_RENDER_DATA_90_FAILED,
+} oled_render_status_t;
 
+// Sends one block of the given buffer to the display, rotating it if needed.
+// Only ever called from one thread, either the main loop or the render thread.
+static oled_render_status_t oled_render_block(const uint8_t *buffer, uint8_t update_start) {
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
@@ -312,33 +329,171 @@ void oled_render(void) {
     }
 
     // Send column & page position
-    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
-        print("oled_render offset command failed\n");
-        return;
+    if (i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &display_start[0], sizeof(display_start), OLED_I2C_TIMEOUT) != I2C_STATUS_SUCCESS) {
+        return OLED_RENDER_OFFSET_FAILED;
     }
 
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
         // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render data failed\n");
-            return;
-        }
-    } else {
-        // Rotate the render chunks
-        const static uint8_t source_map[] = OLED_SOURCE_MAP;
-        const static uint8_t target_map[] = OLED_TARGET_MAP;
-
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+        if (I2C_WRITE_REG(I2C_DATA, &buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+            return OLED_RENDER_DATA_FAILED;
         }
+        return OLED_RENDER_OK;
+    }
+
+    // Rotate the render chunks
+    const static uint8_t source_map[] = OLED_SOURCE_MAP;
+    const static uint8_t target_map[] = OLED_TARGET_MAP;
+
+    static uint8_t temp_buffer[OLED_BLOCK_SIZE];
+    memset(temp_buffer, 0, sizeof(temp_buffer));
+    for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+        rotate_90(&buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+    }
+
+    // Send render data chunk after rotating
+    if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        return OLED_RENDER_DATA_90_FAILED;
+    }
+    return OLED_RENDER_OK;
+}
 
-        // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+static void oled_render_print_status(oled_render_status_t status) {
+    switch (status) {
+        case OLED_RENDER_OFFSET_FAILED:
+            print("oled_render offset command failed\n");
+            break;
+        case OLED_RENDER_DATA_FAILED:
+            print("oled_render data failed\n");
+            break;
+        case OLED_RENDER_DATA_90_FAILED:
             print("oled_render90 data failed\n");
-            return;
+            break;
+        default:
+            break;
+    }
+}
+
+#ifdef OLED_ASYNC_RENDER
+// Blocks are copied to a separate buffer and transmitted by a dedicated thread, so the
+// main loop only waits on the display bus when it needs to send a command itself.
+static uint8_t                  oled_render_buffer[OLED_MATRIX_SIZE];
+static volatile OLED_BLOCK_TYPE oled_render_pending = 0;
+static volatile OLED_BLOCK_TYPE oled_render_failed  = 0;
+static volatile uint8_t         oled_render_status  = OLED_RENDER_OK;
+static volatile bool            oled_render_busy    = false;
+static bool                     oled_render_flushed = false;
+static binary_semaphore_t       oled_render_sem;
+static THD_WORKING_AREA(waOledRenderThread, OLED_ASYNC_RENDER_STACK_SIZE);
+#    if OLED_ASYNC_RENDER_FPS > 0
+static uint16_t oled_render_timer = 0;
+#    endif
+
+static THD_FUNCTION(OledRenderThread, arg) {
+    (void)arg;
+    chRegSetThreadName("oled_render");
+
+    while (true) {
+        chBSemWait(&oled_render_sem);
+
+        OLED_BLOCK_TYPE pending = oled_render_pending;
+        for (uint8_t block = 0; block < OLED_BLOCK_COUNT; ++block) {
+            OLED_BLOCK_TYPE mask = (OLED_BLOCK_TYPE)1 << block;
+            if (pending & mask) {
+                oled_render_status_t status = oled_render_block(oled_render_buffer, block);
+                if (status != OLED_RENDER_OK) {
+                    oled_render_status = status;
+                    oled_render_failed |= mask;
+                }
+            }
         }
+
+        oled_render_pending = 0;
+        oled_render_busy    = false;
+    }
+}
+
+static void oled_render_async_init(void) {
+    static bool started = false;
+    if (!started) {
+        chBSemObjectInit(&oled_render_sem, true);
+        // Above the main loop, so transfers resume as soon as the bus is done with the previous one
+        chThdCreateStatic(waOledRenderThread, sizeof(waOledRenderThread), NORMALPRIO + 1, OledRenderThread, NULL);
+        started = true;
+    }
+}
+
+// Waits for any frame still being transmitted, before the bus is used for a command
+static void oled_render_wait(void) {
+    while (oled_render_busy) {
+        chThdSleep(1);
+    }
+}
+
+void oled_render(void) {
+    if (!oled_initialized || oled_render_busy) {
+        return;
+    }
+
+    // Handle the outcome of the previous frame
+    if (oled_render_failed) {
+        oled_render_print_status(oled_render_status);
+        oled_dirty |= oled_render_failed;
+        oled_render_failed = 0;
+    }
+    if (oled_render_flushed) {
+        // Turn on display if it is off
+        oled_on();
+        oled_render_flushed = false;
+    }
+
+    // Do we have work to do?
+    oled_dirty &= OLED_ALL_BLOCKS_MASK;
+    if (!oled_dirty || oled_scrolling) {
+        return;
+    }
+
+#    if OLED_ASYNC_RENDER_FPS > 0
+    if (timer_elapsed(oled_render_timer) < 1000 / OLED_ASYNC_RENDER_FPS) {
+        return;
+    }
+    oled_render_timer = timer_read();
+#    endif
+
+    // Snapshot all dirty blocks and hand them over
+    for (uint8_t block = 0; block < OLED_BLOCK_COUNT; ++block) {
+        if (oled_dirty & ((OLED_BLOCK_TYPE)1 << block)) {
+            memcpy(&oled_render_buffer[OLED_BLOCK_SIZE * block], &oled_buffer[OLED_BLOCK_SIZE * block], OLED_BLOCK_SIZE);
+        }
+    }
+    oled_render_pending = oled_dirty;
+    oled_render_busy    = true;
+    oled_render_flushed = true;
+    oled_dirty          = 0;
+    chBSemSignal(&oled_render_sem);
+}
+#else
+void oled_render(void) {
+    if (!oled_initialized) {
+        return;
+    }
+
+    // Do we have work to do?
+    oled_dirty &= OLED_ALL_BLOCKS_MASK;
+    if (!oled_dirty || oled_scrolling) {
+        return;
+    }
+
+    // Find first dirty block
+    uint8_t update_start = 0;
+    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
+        ++update_start;
+    }
+
+    oled_render_status_t status = oled_render_block(oled_buffer, update_start);
+    if (status != OLED_RENDER_OK) {
+        oled_render_print_status(status);
+        return;
     }
 
     // Turn on display if it is off
@@ -347,6 +502,7 @@ void oled_render(void) {
     // Clear dirty flag
     oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
 }
+#endif
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
     uint16_t index = line * oled_rotation_width + col * OLED_FONT_WIDTH;
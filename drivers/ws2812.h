@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include "quantum/color.h"
 
 /*
@@ -68,3 +69,13 @@
  *         - Wait 50us to reset the LEDs
  */
 void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds);
+
+/* Returns true while a frame started by ws2812_setleds() is still being sent, or the LEDs
+ * are still latching it. ws2812_setleds() waits for this itself, so callers which can
+ * render the frame later should check it first instead.
+ */
+#if defined(WS2812_DRIVER_GPIO_DMA)
+bool ws2812_is_busy(void);
+#else
+#    define ws2812_is_busy() false
+#endif
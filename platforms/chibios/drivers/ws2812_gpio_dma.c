@@ -0,0 +1,173 @@
+#include "quantum.h"
+#include "ws2812.h"
+#include <ch.h>
+#include <hal.h>
+
+/*
+ * Drives RGB_DI_PIN from a frame buffer of GPIO BSRR values, which a DMA stream copies
+ * to the port on every update event of a general purpose timer. Each bit is split into
+ * three equal slots: the first always drives the line high, the second keeps it high for
+ * a one or pulls it low for a zero, and the third always pulls it low. Unlike the bitbang
+ * driver the CPU is free while the frame is being sent, and unlike the PWM and SPI drivers
+ * any pin can be used.
+ */
+
+#ifndef WS2812_GPIO_DMA_TIMER
+#    define WS2812_GPIO_DMA_TIMER GPTD2  // TIMx
+#endif
+#ifndef WS2812_GPIO_DMA_TIMER_CLOCK
+#    define WS2812_GPIO_DMA_TIMER_CLOCK STM32_TIMCLK1  // Input clock of TIMx, STM32_TIMCLK2 for timers on APB2
+#endif
+#ifndef WS2812_DMA_STREAM
+#    define WS2812_DMA_STREAM STM32_DMA1_STREAM2  // DMA Stream for TIMx_UP
+#endif
+#ifndef WS2812_DMA_CHANNEL
+#    define WS2812_DMA_CHANNEL 2  // DMA Channel for TIMx_UP
+#endif
+#if (STM32_DMA_SUPPORTS_DMAMUX == TRUE) && !defined(WS2812_DMAMUX_ID)
+#    error "please consult your MCU's datasheet and specify in your config.h: #define WS2812_DMAMUX_ID STM32_DMAMUX1_TIM?_UP"
+#endif
+
+// Push Pull or Open Drain Configuration
+// Default Push Pull
+#ifndef WS2812_EXTERNAL_PULLUP
+#    define WS2812_OUTPUT_MODE PAL_MODE_OUTPUT_PUSHPULL
+#else
+#    define WS2812_OUTPUT_MODE PAL_MODE_OUTPUT_OPENDRAIN
+#endif
+
+#ifdef RGBW
+#    define WS2812_CHANNELS 4
+#else
+#    define WS2812_CHANNELS 3
+#endif
+
+/* --- PRIVATE CONSTANTS ---------------------------------------------------- */
+
+/**
+ * @brief   Length of a third of a bit, in timer ticks
+ *
+ * With the default 1250 nS bit window this gives a high period of about 417 nS for a zero
+ * and 833 nS for a one, which is within the specifications of both the WS2812 and WS2812B.
+ */
+#define WS2812_SLOT_TICKS (WS2812_GPIO_DMA_TIMER_CLOCK / (1000000000 / (WS2812_TIMING / 3)))
+
+#define WS2812_SLOTS_PER_BIT 3
+#define WS2812_SLOT_N (RGBLED_NUM * WS2812_CHANNELS * 8 * WS2812_SLOTS_PER_BIT) /**< Number of slots in a frame */
+
+_Static_assert(WS2812_SLOT_N <= 0xFFFF, "Too many LEDs for a single DMA transfer");
+
+#define WS2812_PIN_HIGH (1U << PAL_PAD(RGB_DI_PIN))          /**< BSRR value setting the pin */
+#define WS2812_PIN_LOW (1U << (PAL_PAD(RGB_DI_PIN) + 16))    /**< BSRR value resetting the pin */
+
+/* --- PRIVATE VARIABLES ---------------------------------------------------- */
+
+static uint32_t ws2812_frame_buffer[WS2812_SLOT_N]; /**< Buffer for a frame */
+
+static const stm32_dma_stream_t *ws2812_dma;
+
+static volatile bool      ws2812_busy = false; /**< Set while a frame is being sent */
+static volatile systime_t ws2812_frame_end;    /**< When the last frame finished, for the reset period */
+
+static const GPTConfig ws2812_gpt_config = {
+    .frequency = WS2812_GPIO_DMA_TIMER_CLOCK,
+    .callback  = NULL,
+    .cr2       = 0,
+    .dier      = TIM_DIER_UDE,  // DMA on update event for the next slot
+};
+
+/* --- PRIVATE FUNCTIONS ---------------------------------------------------- */
+
+static void ws2812_dma_done(void *param, uint32_t flags) {
+    (void)param;
+    (void)flags;
+
+    chSysLockFromISR();
+    gptStopTimerI(&WS2812_GPIO_DMA_TIMER);
+    dmaStreamDisable(ws2812_dma);
+    ws2812_frame_end = chVTGetSystemTimeX();
+    ws2812_busy      = false;
+    chSysUnlockFromISR();
+}
+
+static uint32_t *ws2812_encode_byte(uint32_t *slot, uint8_t byte) {
+    // WS2812 protocol wants most significant bits first
+    for (int8_t bit = 7; bit >= 0; bit--) {
+        *slot++ = WS2812_PIN_HIGH;
+        *slot++ = (byte & (1 << bit)) ? 0 : WS2812_PIN_LOW;  // writing 0 to BSRR leaves the pin alone
+        *slot++ = WS2812_PIN_LOW;
+    }
+    return slot;
+}
+
+/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
+
+bool ws2812_is_busy(void) { return ws2812_busy || chVTTimeElapsedSinceX(ws2812_frame_end) <= TIME_US2I(WS2812_TRST_US); }
+
+void ws2812_init(void) {
+    palSetLineMode(RGB_DI_PIN, WS2812_OUTPUT_MODE);
+    writePinLow(RGB_DI_PIN);
+
+    ws2812_dma = dmaStreamAlloc(WS2812_DMA_STREAM - STM32_DMA_STREAM(0), 10, ws2812_dma_done, NULL);
+    dmaStreamSetPeripheral(ws2812_dma, &(PAL_PORT(RGB_DI_PIN)->BSRR));
+    dmaStreamSetMode(ws2812_dma, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC | STM32_DMA_CR_PL(3) | STM32_DMA_CR_TCIE);
+
+#if (STM32_DMA_SUPPORTS_DMAMUX == TRUE)
+    // If the MCU has a DMAMUX we need to assign the correct resource
+    dmaSetRequestSource(ws2812_dma, WS2812_DMAMUX_ID);
+#endif
+
+    gptStart(&WS2812_GPIO_DMA_TIMER, &ws2812_gpt_config);
+
+    ws2812_frame_end = chVTGetSystemTimeX();
+}
+
+// Setleds for standard RGB
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds) {
+    static bool s_init = false;
+    if (!s_init) {
+        ws2812_init();
+        s_init = true;
+    }
+
+    if (leds > RGBLED_NUM) {
+        leds = RGBLED_NUM;
+    }
+
+    // The frame buffer can only be reused once the previous frame is out and the LEDs have
+    // latched it. Callers which check ws2812_is_busy() first never wait here.
+    while (ws2812_is_busy()) {
+    }
+
+    uint32_t *slot = ws2812_frame_buffer;
+    for (uint16_t i = 0; i < leds; i++) {
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+        slot = ws2812_encode_byte(slot, ledarray[i].g);
+        slot = ws2812_encode_byte(slot, ledarray[i].r);
+        slot = ws2812_encode_byte(slot, ledarray[i].b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+        slot = ws2812_encode_byte(slot, ledarray[i].r);
+        slot = ws2812_encode_byte(slot, ledarray[i].g);
+        slot = ws2812_encode_byte(slot, ledarray[i].b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+        slot = ws2812_encode_byte(slot, ledarray[i].b);
+        slot = ws2812_encode_byte(slot, ledarray[i].g);
+        slot = ws2812_encode_byte(slot, ledarray[i].r);
+#endif
+
+#ifdef RGBW
+        slot = ws2812_encode_byte(slot, ledarray[i].w);
+#endif
+    }
+
+    if (slot == ws2812_frame_buffer) {
+        return;
+    }
+
+    // Hand the frame over to the DMA and return, the completion interrupt stops the timer
+    ws2812_busy = true;
+    dmaStreamSetMemory0(ws2812_dma, ws2812_frame_buffer);
+    dmaStreamSetTransactionSize(ws2812_dma, slot - ws2812_frame_buffer);
+    dmaStreamEnable(ws2812_dma);
+    gptStartContinuous(&WS2812_GPIO_DMA_TIMER, WS2812_SLOT_TICKS);
+}
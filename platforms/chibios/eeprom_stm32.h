@@ -29,5 +29,8 @@ uint8_t  EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte);
 uint8_t  EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord);
 uint8_t  EEPROM_ReadDataByte(uint16_t Address);
 uint16_t EEPROM_ReadDataWord(uint16_t Address);
+#ifdef FEE_PAGE_SWAPPING
+bool EEPROM_Task(void);
+#endif
 
 void print_eeprom(void);
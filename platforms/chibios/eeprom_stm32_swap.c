@@ -0,0 +1,775 @@
+/*
+ * This software is experimental and a work in progress.
+ * Under no circumstances should these files be used in relation to any critical system(s).
+ * Use of these files is at your own risk.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Page swapping variant of eeprom_stm32.c, sharing its compacted area and write log encoding.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "util.h"
+#include "debug.h"
+#include "eeprom_stm32.h"
+#include "flash_stm32.h"
+
+/*
+ * The allocated flash pages are split into two banks of FEE_PAGE_COUNT / 2 pages.
+ * Each bank holds a small header, followed by a compacted view of the EEPROM contents
+ * and a write log, using the same encoding as eeprom_stm32.c:
+ *
+ * === SIMULATED EEPROM CONTENTS ===
+ *
+ * ┌─────────────── Bank 0 ───────────────┬─────────────── Bank 1 ───────────────┐
+ * │[HEADER]│ Compacted  │    Write Log    │[HEADER]│ Compacted  │    Write Log    │
+ * └────────┴────────────┴─────────────────┴────────┴────────────┴─────────────────┘
+ *
+ * ╔══════════ Bank Header ═══════════╗
+ * ║ Sequence ║ Magic ║ State ║ FFFF  ║
+ * ╚══════════╩═══════╩═══════╩═══════╝
+ * State is FFFF while the bank is being filled from the other bank, and 0000 once complete.
+ *
+ * Only one bank is written to at a time. When its write log is full, the other bank is
+ * given a newer sequence number and becomes the active bank. Rather than rewriting the
+ * whole EEPROM at that point, words are migrated from the previous bank a few at a time
+ * by EEPROM_Task(), and the previous bank is then erased one page at a time. Pages are
+ * therefore erased alternately, and never inside a write.
+ *
+ * While a migration is in progress:
+ * - A word whose compacted value in the active bank is still unprogrammed has not been
+ *   written since the swap, so its value is read from the previous bank.
+ * - Before a write lands in the write log of the active bank, the previous value of that
+ *   word is copied into the compacted area first. The compacted area of the active bank
+ *   being unprogrammed therefore always implies there are no log entries for that word.
+ * Migration is restartable, so an interrupted migration simply resumes at EEPROM_Init().
+ *
+ * Reads are resolved from flash through a direct-mapped cache of FEE_CACHE_SIZE words, each
+ * miss replaying the write log. Alternatively, if FEE_DENSITY_BYTES is no larger than
+ * FEE_MIRROR_MAX_BYTES, reads are served from a full copy of the EEPROM contents in RAM, as in
+ * eeprom_stm32.c, built with a single pass over each bank at init.
+ *
+ * The following configuration defines can be set:
+ *
+ * FEE_PAGE_COUNT          # Total number of pages to use for both banks; must be even
+ * FEE_DENSITY_BYTES       # Size of simulated eeprom. (Defaults to half of a bank)
+ * FEE_MIRROR_MAX_BYTES    # Largest FEE_DENSITY_BYTES kept entirely in RAM (Defaults to 0, always use the cache)
+ * FEE_CACHE_SIZE          # Number of words kept in the read cache; must be a power of 2 (Defaults to 64)
+ * FEE_SWAP_WORDS_PER_TASK # Number of words migrated by each call to EEPROM_Task() (Defaults to 8)
+ */
+
+#include "eeprom_stm32_defs.h"
+#if !defined(FEE_PAGE_SIZE) || !defined(FEE_PAGE_COUNT) || !defined(FEE_MCU_FLASH_SIZE) || !defined(FEE_PAGE_BASE_ADDRESS)
+#    error "not implemented."
+#endif
+
+#if (FEE_PAGE_COUNT < 2) || ((FEE_PAGE_COUNT % 2) == 1)
+#    error emulated eeprom: FEE_PAGE_COUNT must be a multiple of 2 when page swapping
+#endif
+
+/* These bits are used for optimizing encoding of bytes, 0 and 1 */
+#define FEE_WORD_ENCODING 0x8000
+#define FEE_VALUE_NEXT 0x6000
+#define FEE_VALUE_RESERVED 0x4000
+#define FEE_VALUE_ENCODED 0x2000
+#define FEE_BYTE_RANGE 0x80
+
+/* Addressable range 16KByte: 0 <-> (0x1FFF << 1) */
+#define FEE_ADDRESS_MAX_SIZE 0x4000
+
+/* Flash word value after erase */
+#define FEE_EMPTY_WORD ((uint16_t)0xFFFF)
+
+/* Size of combined pages of both banks */
+#define FEE_DENSITY_MAX_SIZE (FEE_PAGE_COUNT * FEE_PAGE_SIZE)
+
+#ifndef FEE_MCU_FLASH_SIZE_IGNORE_CHECK /* *TODO: Get rid of this check */
+#    if FEE_DENSITY_MAX_SIZE > (FEE_MCU_FLASH_SIZE * 1024)
+#        pragma message STR(FEE_DENSITY_MAX_SIZE) " > " STR(FEE_MCU_FLASH_SIZE * 1024)
+#        error emulated eeprom: FEE_DENSITY_MAX_SIZE is greater than available flash size
+#    endif
+#endif
+
+/* Bank geometry */
+#define FEE_BANK_PAGES (FEE_PAGE_COUNT / 2)
+#define FEE_BANK_SIZE (FEE_BANK_PAGES * FEE_PAGE_SIZE)
+#define FEE_BANK_BASE_ADDRESS(bank) (FEE_PAGE_BASE_ADDRESS + (bank)*FEE_BANK_SIZE)
+
+/* Bank header layout, in words */
+#define FEE_HEADER_BYTES 8
+#define FEE_HEADER_SEQUENCE 0
+#define FEE_HEADER_MAGIC 1
+#define FEE_HEADER_STATE 2
+#define FEE_BANK_MAGIC ((uint16_t)0x5EE9)
+#define FEE_BANK_COMPLETE ((uint16_t)0x0000)
+
+/* Size of emulated eeprom */
+#ifdef FEE_DENSITY_BYTES
+#    if FEE_DENSITY_BYTES > FEE_ADDRESS_MAX_SIZE
+#        pragma message STR(FEE_DENSITY_BYTES) " > " STR(FEE_ADDRESS_MAX_SIZE)
+#        error emulated eeprom: FEE_DENSITY_BYTES is greater than FEE_ADDRESS_MAX_SIZE allows
+#    endif
+#    if ((FEE_DENSITY_BYTES) % 2) == 1
+#        error emulated eeprom: FEE_DENSITY_BYTES must be even
+#    endif
+#else
+/* Default to half of each bank used for emulated eeprom, half for header and write log */
+#    define FEE_DENSITY_BYTES (FEE_BANK_SIZE / 2)
+#endif
+
+/* Size of write log: all remaining space in the bank */
+#define FEE_WRITE_LOG_BYTES (FEE_BANK_SIZE - FEE_HEADER_BYTES - FEE_DENSITY_BYTES)
+#if FEE_WRITE_LOG_BYTES < 4
+#    pragma message STR(FEE_DENSITY_BYTES) " + " STR(FEE_HEADER_BYTES) " > " STR(FEE_BANK_SIZE - 4)
+#    error emulated eeprom: FEE_DENSITY_BYTES leaves no room for a write log in each bank
+#endif
+
+/* Start of the emulated eeprom compacted flash area of a bank */
+#define FEE_COMPACTED_BASE_ADDRESS(bank) (FEE_BANK_BASE_ADDRESS(bank) + FEE_HEADER_BYTES)
+/* Start of the emulated eeprom write log of a bank */
+#define FEE_WRITE_LOG_BASE_ADDRESS(bank) (FEE_COMPACTED_BASE_ADDRESS(bank) + FEE_DENSITY_BYTES)
+/* End of the emulated eeprom write log of a bank */
+#define FEE_WRITE_LOG_LAST_ADDRESS(bank) (FEE_WRITE_LOG_BASE_ADDRESS(bank) + FEE_WRITE_LOG_BYTES)
+
+#define FEE_HEADER(bank) ((uint16_t *)FEE_BANK_BASE_ADDRESS(bank))
+#define FEE_COMPACTED(bank) ((uint16_t *)FEE_COMPACTED_BASE_ADDRESS(bank))
+
+#if defined(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) && (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR >= FEE_DENSITY_BYTES)
+#    error emulated eeprom: DYNAMIC_KEYMAP_EEPROM_MAX_ADDR is greater than the FEE_DENSITY_BYTES available
+#endif
+
+#ifndef FEE_MIRROR_MAX_BYTES
+#    define FEE_MIRROR_MAX_BYTES 0
+#endif
+#if FEE_DENSITY_BYTES <= FEE_MIRROR_MAX_BYTES
+#    define FEE_RAM_MIRROR
+#endif
+
+#ifndef FEE_CACHE_SIZE
+#    define FEE_CACHE_SIZE 64
+#endif
+#if (FEE_CACHE_SIZE & (FEE_CACHE_SIZE - 1)) != 0
+#    error emulated eeprom: FEE_CACHE_SIZE must be a power of 2
+#endif
+
+#ifndef FEE_SWAP_WORDS_PER_TASK
+#    define FEE_SWAP_WORDS_PER_TASK 8
+#endif
+
+#ifdef FEE_RAM_MIRROR
+/* Current value of every word of emulated eeprom */
+static uint16_t mirror[FEE_DENSITY_BYTES / 2];
+#else
+/* Cached word of emulated eeprom, address is FEE_EMPTY_WORD when unused */
+typedef struct {
+    uint16_t address;
+    uint16_t value;
+} fee_cache_entry_t;
+
+static fee_cache_entry_t cache[FEE_CACHE_SIZE];
+#endif
+
+/* Decoded write log entry, only the bits set in mask are written */
+typedef struct {
+    uint16_t address;
+    uint16_t value;
+    uint16_t mask;
+} fee_log_entry_t;
+
+/* Bank receiving writes */
+static uint8_t active_bank;
+/* Sequence number of the active bank */
+static uint16_t active_sequence;
+/* Set while words are still being copied from the other bank */
+static bool migrating;
+/* Next address to be copied from the other bank */
+static uint16_t migrate_address;
+/* Number of pages of the other bank still to be erased */
+static uint8_t erase_pages;
+
+/* Pointer to the first available slot within the write log of the active bank */
+static uint16_t *empty_slot;
+
+// #define DEBUG_EEPROM_OUTPUT
+
+/*
+ * Debug print utils
+ */
+
+#if defined(DEBUG_EEPROM_OUTPUT)
+
+#    define debug_eeprom debug_enable
+#    define eeprom_println(s) println(s)
+#    define eeprom_printf(fmt, ...) xprintf(fmt, ##__VA_ARGS__);
+
+#else /* NO_DEBUG */
+
+#    define debug_eeprom false
+#    define eeprom_println(s)
+#    define eeprom_printf(fmt, ...)
+
+#endif /* NO_DEBUG */
+
+void print_eeprom(void) {
+#ifndef NO_DEBUG
+    for (uint16_t i = 0; i < FEE_DENSITY_BYTES; i++) {
+        if (i % 16 == 0) xprintf("%04x", i);
+        if (i % 8 == 0) print(" ");
+
+        xprintf(" %02x", EEPROM_ReadDataByte(i));
+        if ((i + 1) % 16 == 0) {
+            println("");
+        }
+    }
+#endif
+}
+
+/*
+ * Flash access
+ */
+
+static inline uint8_t other_bank(void) { return active_bank ^ 1; }
+
+/* Decode the write log entry at *log_addr and step past it, returns false at the end of the log */
+static bool bank_next_log_entry(uint8_t bank, uint16_t **log_addr, fee_log_entry_t *entry) {
+    if (*log_addr >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank)) {
+        return false;
+    }
+    uint16_t address = *(*log_addr)++;
+    if (address == FEE_EMPTY_WORD) {
+        return false;
+    }
+
+    entry->address = FEE_EMPTY_WORD;
+    entry->value   = 0;
+    entry->mask    = 0xFFFF;
+    /* Check for lowest 128-bytes optimization */
+    if (!(address & FEE_WORD_ENCODING)) {
+        uint8_t bvalue = (uint8_t)address;
+        address >>= 8;
+        entry->address = address & 0xFFFE;
+        entry->value   = (address & 1) ? (bvalue << 8) : bvalue;
+        entry->mask    = (address & 1) ? 0xFF00 : 0x00FF;
+    } else if ((address & FEE_VALUE_NEXT) == FEE_VALUE_NEXT) {
+        /* Read value from next word */
+        if (*log_addr >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank)) {
+            return false;
+        }
+        entry->value = ~*(*log_addr)++;
+        if (!entry->value) {
+            /* Possibly incomplete write.  Ignore and continue */
+            entry->mask = 0;
+        }
+        /* Writes to addresses less than 128 are byte log entries */
+        entry->address = ((address & 0x1FFF) << 1) + FEE_BYTE_RANGE;
+    } else if (address & FEE_VALUE_RESERVED) {
+        /* Reserved for future use */
+        entry->mask = 0;
+    } else {
+        /* Optimization for 0 or 1 values. */
+        entry->value   = (address & FEE_VALUE_ENCODED) >> 13;
+        entry->address = (address & 0x1FFF) << 1;
+    }
+    return true;
+}
+
+#ifndef FEE_RAM_MIRROR
+/* Resolve the value of a word from the compacted area and write log of a bank */
+static uint16_t bank_read_word(uint8_t bank, uint16_t Address) {
+    uint16_t value = ~FEE_COMPACTED(bank)[Address >> 1];
+
+    /* Replay write log */
+    uint16_t *      log_addr = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(bank);
+    fee_log_entry_t entry;
+    while (bank_next_log_entry(bank, &log_addr, &entry)) {
+        if (entry.address == Address) {
+            value = (value & ~entry.mask) | (entry.value & entry.mask);
+        }
+    }
+
+    return value;
+}
+#endif
+
+/* Find the first unprogrammed slot in the write log of a bank */
+static uint16_t *bank_find_empty_slot(uint8_t bank) {
+    uint16_t *log_addr;
+    for (log_addr = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(bank); log_addr < (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank); ++log_addr) {
+        uint16_t address = *log_addr;
+        if (address == FEE_EMPTY_WORD) {
+            break;
+        }
+        /* Skip over the value word */
+        if ((address & (FEE_WORD_ENCODING | FEE_VALUE_NEXT)) == (FEE_WORD_ENCODING | FEE_VALUE_NEXT)) {
+            ++log_addr;
+        }
+    }
+    if (log_addr > (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank)) {
+        log_addr = (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank);
+    }
+    return log_addr;
+}
+
+static bool bank_is_blank(uint8_t bank) {
+    for (uint16_t *addr = FEE_HEADER(bank); addr < (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank); ++addr) {
+        if (*addr != FEE_EMPTY_WORD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool bank_is_valid(uint8_t bank) { return FEE_HEADER(bank)[FEE_HEADER_MAGIC] == FEE_BANK_MAGIC; }
+
+static bool bank_is_complete(uint8_t bank) { return FEE_HEADER(bank)[FEE_HEADER_STATE] == FEE_BANK_COMPLETE; }
+
+static FLASH_Status program_word(uintptr_t address, uint16_t value) {
+    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)address, value);
+    FLASH_Unlock();
+    FLASH_Status status = FLASH_ProgramHalfWord(address, value);
+    FLASH_Lock();
+    return status;
+}
+
+static FLASH_Status erase_page(uint8_t bank, uint8_t page_num) {
+    eeprom_printf("FLASH_ErasePage(0x%04x)\n", (uint32_t)(FEE_BANK_BASE_ADDRESS(bank) + (page_num * FEE_PAGE_SIZE)));
+    FLASH_Unlock();
+    FLASH_Status status = FLASH_ErasePage(FEE_BANK_BASE_ADDRESS(bank) + (page_num * FEE_PAGE_SIZE));
+    FLASH_Lock();
+    return status;
+}
+
+/* Erase the pending pages of the other bank, header page last */
+static void erase_step(uint8_t count) {
+    for (; erase_pages && count; --count) {
+        erase_page(other_bank(), --erase_pages);
+    }
+}
+
+/* Start using a bank, sequence first so a bank with a valid magic always has one */
+static void bank_start(uint8_t bank, uint16_t sequence) {
+    program_word((uintptr_t)&FEE_HEADER(bank)[FEE_HEADER_SEQUENCE], sequence);
+    program_word((uintptr_t)&FEE_HEADER(bank)[FEE_HEADER_MAGIC], FEE_BANK_MAGIC);
+
+    active_bank     = bank;
+    active_sequence = sequence;
+    empty_slot      = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(bank);
+}
+
+static void bank_complete(void) {
+    program_word((uintptr_t)&FEE_HEADER(active_bank)[FEE_HEADER_STATE], FEE_BANK_COMPLETE);
+    migrating   = false;
+    erase_pages = FEE_BANK_PAGES;
+}
+
+/*
+ * Migration
+ */
+
+/* Copy a word from the other bank, unless it has been written since the swap */
+static FLASH_Status migrate_word(uint16_t Address) {
+    if (FEE_COMPACTED(active_bank)[Address >> 1] != FEE_EMPTY_WORD) {
+        return FLASH_COMPLETE;
+    }
+#ifdef FEE_RAM_MIRROR
+    /* Not written since the swap, so the copy in RAM still holds the value from the other bank */
+    uint16_t value = mirror[Address >> 1];
+#else
+    uint16_t value = bank_read_word(other_bank(), Address);
+#endif
+    if (!value) {
+        return FLASH_COMPLETE;
+    }
+    return program_word(FEE_COMPACTED_BASE_ADDRESS(active_bank) + Address, ~value);
+}
+
+static void migrate_step(uint16_t count) {
+    for (; migrating && count; --count) {
+        migrate_word(migrate_address);
+        migrate_address += 2;
+        if (migrate_address >= FEE_DENSITY_BYTES) {
+            bank_complete();
+        }
+    }
+}
+
+/* Switch writes over to the other bank, finishing any outstanding background work first */
+static void eeprom_swap(void) {
+    migrate_step(FEE_DENSITY_BYTES / 2);
+    erase_step(FEE_BANK_PAGES);
+
+    uint16_t sequence = active_sequence + 1;
+    if (sequence == FEE_EMPTY_WORD) {
+        sequence = 0;
+    }
+    eeprom_printf("eeprom_swap: bank %d -> %d\n", active_bank, other_bank());
+    bank_start(other_bank(), sequence);
+
+    migrating       = true;
+    migrate_address = 0;
+}
+
+bool EEPROM_Task(void) {
+    if (migrating) {
+        migrate_step(FEE_SWAP_WORDS_PER_TASK);
+    } else if (erase_pages) {
+        erase_step(1);
+    }
+    return migrating || erase_pages;
+}
+
+/*
+ * Cache
+ */
+
+#ifdef FEE_RAM_MIRROR
+/* Apply the write log of a bank to the copy in RAM */
+static void mirror_replay_log(uint8_t bank) {
+    uint16_t *      log_addr = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(bank);
+    fee_log_entry_t entry;
+    while (bank_next_log_entry(bank, &log_addr, &entry)) {
+        if (entry.address < FEE_DENSITY_BYTES) {
+            uint16_t *word = &mirror[entry.address >> 1];
+            *word          = (*word & ~entry.mask) | (entry.value & entry.mask);
+        }
+    }
+}
+
+/* Build the copy in RAM, words not yet migrated come from the other bank */
+static void cache_init(void) {
+    if (migrating) {
+        for (uint16_t i = 0; i < FEE_DENSITY_BYTES / 2; ++i) {
+            mirror[i] = ~FEE_COMPACTED(other_bank())[i];
+        }
+        mirror_replay_log(other_bank());
+    }
+    for (uint16_t i = 0; i < FEE_DENSITY_BYTES / 2; ++i) {
+        if (!migrating || FEE_COMPACTED(active_bank)[i] != FEE_EMPTY_WORD) {
+            mirror[i] = ~FEE_COMPACTED(active_bank)[i];
+        }
+    }
+    /* Words logged in the active bank always have their compacted value there */
+    mirror_replay_log(active_bank);
+}
+
+/* Read an aligned word */
+static inline uint16_t eeprom_read_word_cached(uint16_t Address) { return mirror[Address >> 1]; }
+
+static inline void cache_update(uint16_t Address, uint16_t value) { mirror[Address >> 1] = value; }
+#else
+static void cache_init(void) {
+    for (uint16_t i = 0; i < FEE_CACHE_SIZE; ++i) {
+        cache[i].address = FEE_EMPTY_WORD;
+    }
+}
+
+static inline fee_cache_entry_t *cache_entry(uint16_t Address) { return &cache[(Address >> 1) & (FEE_CACHE_SIZE - 1)]; }
+
+/* Read an aligned word */
+static uint16_t eeprom_read_word_cached(uint16_t Address) {
+    fee_cache_entry_t *entry = cache_entry(Address);
+    if (entry->address != Address) {
+        entry->address = Address;
+        if (migrating && FEE_COMPACTED(active_bank)[Address >> 1] == FEE_EMPTY_WORD) {
+            entry->value = bank_read_word(other_bank(), Address);
+        } else {
+            entry->value = bank_read_word(active_bank, Address);
+        }
+    }
+    return entry->value;
+}
+
+static inline void cache_update(uint16_t Address, uint16_t value) {
+    cache_entry(Address)->address = Address;
+    cache_entry(Address)->value   = value;
+}
+#endif
+
+/*
+ * Initialization
+ */
+
+uint16_t EEPROM_Init(void) {
+    migrating   = false;
+    erase_pages = 0;
+
+    bool valid0 = bank_is_valid(0);
+    bool valid1 = bank_is_valid(1);
+
+    if (valid0 && valid1) {
+        /* Both banks in use: the newer one is active, and either still migrating or complete */
+        int16_t age = FEE_HEADER(1)[FEE_HEADER_SEQUENCE] - FEE_HEADER(0)[FEE_HEADER_SEQUENCE];
+        active_bank = age > 0 ? 1 : 0;
+        if (bank_is_complete(active_bank)) {
+            erase_pages = FEE_BANK_PAGES;
+        } else {
+            migrating       = true;
+            migrate_address = 0;
+        }
+    } else if (valid0 || valid1) {
+        active_bank = valid1 ? 1 : 0;
+        if (!bank_is_complete(active_bank)) {
+            /* Source bank is gone; nothing more can be recovered */
+            program_word((uintptr_t)&FEE_HEADER(active_bank)[FEE_HEADER_STATE], FEE_BANK_COMPLETE);
+        }
+        if (!bank_is_blank(other_bank())) {
+            erase_pages = FEE_BANK_PAGES;
+        }
+    } else {
+        /* Neither bank in use: start afresh */
+        for (uint8_t bank = 0; bank < 2; ++bank) {
+            if (!bank_is_blank(bank)) {
+                for (uint8_t page_num = 0; page_num < FEE_BANK_PAGES; ++page_num) {
+                    erase_page(bank, page_num);
+                }
+            }
+        }
+        bank_start(0, 0);
+        program_word((uintptr_t)&FEE_HEADER(0)[FEE_HEADER_STATE], FEE_BANK_COMPLETE);
+    }
+
+    active_sequence = FEE_HEADER(active_bank)[FEE_HEADER_SEQUENCE];
+    empty_slot      = bank_find_empty_slot(active_bank);
+    cache_init();
+
+    eeprom_printf("EEPROM_Init: bank %d, sequence %d, migrating %d, erase %d\n", active_bank, active_sequence, migrating, erase_pages);
+
+    return FEE_DENSITY_BYTES;
+}
+
+/* Erase emulated eeprom */
+void EEPROM_Erase(void) {
+    eeprom_println("EEPROM_Erase");
+    for (uint8_t bank = 0; bank < 2; ++bank) {
+        for (uint8_t page_num = 0; page_num < FEE_BANK_PAGES; ++page_num) {
+            erase_page(bank, page_num);
+        }
+    }
+    /* re-initialize to reset state */
+    EEPROM_Init();
+}
+
+/*
+ * Writes
+ */
+
+/* Append log entries for the changed word, returns 0 if the write log is full */
+static uint8_t eeprom_write_log_entry(uint16_t Address, uint16_t oldValue, uint16_t value) {
+    uint16_t entries[4];
+    uint8_t  count = 0;
+
+    if (Address < FEE_BYTE_RANGE) {
+        /* Only write a byte if it has changed */
+        if ((uint8_t)oldValue != (uint8_t)value) {
+            entries[count++] = (Address << 8) | (uint8_t)value;
+        }
+        if ((oldValue >> 8) != (value >> 8)) {
+            entries[count++] = ((Address + 1) << 8) | (value >> 8);
+        }
+    } else if (value <= 1) {
+        entries[count++] = FEE_WORD_ENCODING | (value << 13) | (Address >> 1);
+    } else {
+        /* Writes to addresses less than 128 are byte log entries */
+        entries[count++] = FEE_WORD_ENCODING | FEE_VALUE_NEXT | ((Address - FEE_BYTE_RANGE) >> 1);
+        entries[count++] = ~value;
+    }
+
+    if (empty_slot + count > (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(active_bank)) {
+        return 0;
+    }
+
+    FLASH_Status final_status = FLASH_COMPLETE;
+    for (uint8_t i = 0; i < count; ++i) {
+        FLASH_Status status = program_word((uintptr_t)empty_slot++, entries[i]);
+        if (status != FLASH_COMPLETE) final_status = status;
+    }
+    return final_status;
+}
+
+/* Write an aligned word */
+static uint8_t eeprom_write_word(uint16_t Address, uint16_t value) {
+    uint16_t oldValue = eeprom_read_word_cached(Address);
+    /* if the value is the same, don't bother writing it */
+    if (oldValue == value) {
+        eeprom_printf("eeprom_write_word(0x%04x, 0x%04x) [SKIP SAME]\n", Address, value);
+        return 0;
+    }
+
+    FLASH_Status status;
+    bool         unprogrammed = FEE_COMPACTED(active_bank)[Address >> 1] == FEE_EMPTY_WORD;
+    if (unprogrammed && !(migrating && oldValue)) {
+        /* Write the value directly to the compacted area without a log entry */
+        status = program_word(FEE_COMPACTED_BASE_ADDRESS(active_bank) + Address, ~value);
+    } else {
+        if (unprogrammed) {
+            /* Bring the word over from the other bank before logging the change */
+            migrate_word(Address);
+        }
+        status = eeprom_write_log_entry(Address, oldValue, value);
+        if (!status) {
+            /* Write log is full, continue in the other bank */
+            eeprom_swap();
+            return eeprom_write_word(Address, value);
+        }
+    }
+
+    cache_update(Address, value);
+
+    return status;
+}
+
+uint8_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
+    /* if the address is out-of-bounds, do nothing */
+    if (Address >= FEE_DENSITY_BYTES) {
+        eeprom_printf("EEPROM_WriteDataByte(0x%04x, 0x%02x) [BAD ADDRESS]\n", Address, DataByte);
+        return FLASH_BAD_ADDRESS;
+    }
+
+    uint16_t value = eeprom_read_word_cached(Address & 0xFFFE);
+    if (Address % 2) {
+        value = (value & 0x00FF) | (DataByte << 8);
+    } else {
+        value = (value & 0xFF00) | DataByte;
+    }
+
+    uint8_t status = eeprom_write_word(Address & 0xFFFE, value);
+    if (status != 0 && status != FLASH_COMPLETE) {
+        eeprom_printf("EEPROM_WriteDataByte [STATUS == %d]\n", status);
+    }
+    return status;
+}
+
+uint8_t EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord) {
+    /* if the address is out-of-bounds, do nothing */
+    if (Address >= FEE_DENSITY_BYTES) {
+        eeprom_printf("EEPROM_WriteDataWord(0x%04x, 0x%04x) [BAD ADDRESS]\n", Address, DataWord);
+        return FLASH_BAD_ADDRESS;
+    }
+
+    /* Check for word alignment */
+    FLASH_Status final_status = FLASH_COMPLETE;
+    if (Address % 2) {
+        final_status        = EEPROM_WriteDataByte(Address, DataWord);
+        FLASH_Status status = EEPROM_WriteDataByte(Address + 1, DataWord >> 8);
+        if (status != FLASH_COMPLETE) final_status = status;
+        if (final_status != 0 && final_status != FLASH_COMPLETE) {
+            eeprom_printf("EEPROM_WriteDataWord [STATUS == %d]\n", final_status);
+        }
+        return final_status;
+    }
+
+    final_status = eeprom_write_word(Address, DataWord);
+    if (final_status != 0 && final_status != FLASH_COMPLETE) {
+        eeprom_printf("EEPROM_WriteDataWord [STATUS == %d]\n", final_status);
+    }
+    return final_status;
+}
+
+/*
+ * Reads
+ */
+
+uint8_t EEPROM_ReadDataByte(uint16_t Address) {
+    uint8_t DataByte = 0xFF;
+
+    if (Address < FEE_DENSITY_BYTES) {
+        uint16_t value = eeprom_read_word_cached(Address & 0xFFFE);
+        DataByte       = (Address % 2) ? (value >> 8) : value;
+    }
+
+    eeprom_printf("EEPROM_ReadDataByte(0x%04x): 0x%02x\n", Address, DataByte);
+
+    return DataByte;
+}
+
+uint16_t EEPROM_ReadDataWord(uint16_t Address) {
+    uint16_t DataWord = 0xFFFF;
+
+    if (Address < FEE_DENSITY_BYTES - 1) {
+        /* Check word alignment */
+        if (Address % 2) {
+            DataWord = EEPROM_ReadDataByte(Address) | (EEPROM_ReadDataByte(Address + 1) << 8);
+        } else {
+            DataWord = eeprom_read_word_cached(Address);
+        }
+    }
+
+    eeprom_printf("EEPROM_ReadDataWord(0x%04x): 0x%04x\n", Address, DataWord);
+
+    return DataWord;
+}
+
+/*****************************************************************************
+ *  Bind to eeprom_driver.c
+ *******************************************************************************/
+void eeprom_driver_init(void) { EEPROM_Init(); }
+
+void eeprom_driver_erase(void) { EEPROM_Erase(); }
+
+void eeprom_driver_task(void) { EEPROM_Task(); }
+
+void eeprom_driver_read_block(void *buf, const void *addr, size_t len) {
+    const uint8_t *src  = (const uint8_t *)addr;
+    uint8_t *      dest = (uint8_t *)buf;
+
+    /* Check word alignment */
+    if (len && (uintptr_t)src % 2) {
+        /* Read the unaligned first byte */
+        *dest++ = EEPROM_ReadDataByte((const uintptr_t)src++);
+        --len;
+    }
+
+    uint16_t value;
+    bool     aligned = ((uintptr_t)dest % 2 == 0);
+    while (len > 1) {
+        value = EEPROM_ReadDataWord((const uintptr_t)((uint16_t *)src));
+        if (aligned) {
+            *(uint16_t *)dest = value;
+            dest += 2;
+        } else {
+            *dest++ = value;
+            *dest++ = value >> 8;
+        }
+        src += 2;
+        len -= 2;
+    }
+    if (len) {
+        *dest = EEPROM_ReadDataByte((const uintptr_t)src);
+    }
+}
+
+void eeprom_driver_write_block(const void *buf, void *addr, size_t len) {
+    uint8_t *      dest = (uint8_t *)addr;
+    const uint8_t *src  = (const uint8_t *)buf;
+
+    /* Check word alignment */
+    if (len && (uintptr_t)dest % 2) {
+        /* Write the unaligned first byte */
+        EEPROM_WriteDataByte((uintptr_t)dest++, *src++);
+        --len;
+    }
+
+    uint16_t value;
+    bool     aligned = ((uintptr_t)src % 2 == 0);
+    while (len > 1) {
+        if (aligned) {
+            value = *(uint16_t *)src;
+        } else {
+            value = *(uint8_t *)src | (*(uint8_t *)(src + 1) << 8);
+        }
+        EEPROM_WriteDataWord((uintptr_t)((uint16_t *)dest), value);
+        dest += 2;
+        src += 2;
+        len -= 2;
+    }
+
+    if (len) {
+        EEPROM_WriteDataByte((uintptr_t)dest, *src);
+    }
+}
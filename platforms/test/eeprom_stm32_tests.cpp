@@ -44,12 +44,47 @@ extern "C" {
  * [Unused | Compact |  Write Log  ]
  * [0......|512......|768......1023]
  *
+ * === Swap Large Layout ===
+ * flash size: 65536
+ * page size: 2048
+ * density pages: 16
+ * Simulated EEPROM size: 8192
+ *
+ * FlashBuf Layout:
+ * [Unused | Header | Compact |  Write Log  | Header | Compact |  Write Log  ]
+ * [0......|32768...|32776......|40968......|49152...|49160......|57352......65535]
+ *
+ * === Swap Tiny Layout ===
+ * flash size: 1024
+ * page size: 512
+ * density pages: 2
+ * Simulated EEPROM size: 256
+ *
+ * FlashBuf Layout:
+ * [Header | Compact |  Write Log  | Header | Compact |  Write Log  ]
+ * [0......|8......|264......|512......|520......|776......1023]
+ *
  */
 
-#define EEPROM_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
-#define LOG_SIZE EEPROM_SIZE
-#define LOG_BASE (MOCK_FLASH_SIZE - LOG_SIZE)
-#define EEPROM_BASE (LOG_BASE - EEPROM_SIZE)
+#ifdef FEE_PAGE_SWAPPING
+#    define BANK_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
+#    define BANK_BASE(bank) (MOCK_FLASH_SIZE - (2 - (bank)) * BANK_SIZE)
+#    define HEADER_SIZE 8
+#    define EEPROM_SIZE (BANK_SIZE / 2)
+#    define LOG_SIZE (BANK_SIZE - HEADER_SIZE - EEPROM_SIZE)
+#    define EEPROM_BASE (BANK_BASE(0) + HEADER_SIZE)
+#    define LOG_BASE (EEPROM_BASE + EEPROM_SIZE)
+
+/* Bank header helpers */
+#    define BANK_SEQUENCE(bank) (*(uint16_t*)&FlashBuf[BANK_BASE(bank)])
+#    define BANK_MAGIC(bank) (*(uint16_t*)&FlashBuf[BANK_BASE(bank) + 2])
+#    define BANK_STATE(bank) (*(uint16_t*)&FlashBuf[BANK_BASE(bank) + 4])
+#else
+#    define EEPROM_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
+#    define LOG_SIZE EEPROM_SIZE
+#    define LOG_BASE (MOCK_FLASH_SIZE - LOG_SIZE)
+#    define EEPROM_BASE (LOG_BASE - EEPROM_SIZE)
+#endif
 
 /* Log encoding helpers */
 #define BYTE_VALUE(addr, value) (((addr) << 8) | (value))
@@ -427,6 +462,10 @@ TEST_F(EepromStm32Test, TestCompaction) {
     EXPECT_NE(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
     /* Run compaction */
     eeprom_write_byte((uint8_t*)4, 0x1f);
+#ifdef FEE_PAGE_SWAPPING
+    while (EEPROM_Task()) {
+    }
+#endif
     EEPROM_Init();
     EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
     EXPECT_EQ(eeprom_read_byte((uint8_t*)4), 0x1f);
@@ -436,3 +475,101 @@ TEST_F(EepromStm32Test, TestCompaction) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], 0xFFFF);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
 }
+
+#ifdef FEE_PAGE_SWAPPING
+static bool bank_is_blank(int bank) {
+    for (int i = 0; i < BANK_SIZE; ++i) {
+        if (FlashBuf[BANK_BASE(bank) + i] != 0xFF) return false;
+    }
+    return true;
+}
+
+TEST_F(EepromStm32Test, TestSwapHeader) {
+    EXPECT_EQ(BANK_SEQUENCE(0), 0);
+    EXPECT_EQ(BANK_MAGIC(0), 0x5EE9);
+    EXPECT_EQ(BANK_STATE(0), 0);
+    EXPECT_TRUE(bank_is_blank(1));
+}
+
+TEST_F(EepromStm32Test, TestSwapMigration) {
+    /* Direct writes */
+    eeprom_write_dword((uint32_t*)0, 0xdeadbeef);
+    eeprom_write_word((uint16_t*)150, 0xd00d);
+    eeprom_write_word((uint16_t*)152, 0xcafe);
+    eeprom_write_word((uint16_t*)(EEPROM_SIZE - 2), 0xf00d);
+    /* Fill write log until the other bank takes over */
+    uint32_t i;
+    uint32_t val = 0xd8453c6b;
+    for (i = 0; BANK_MAGIC(1) == 0xFFFF; i++) {
+        val ^= 0x593ca5b3;
+        val += i;
+        eeprom_write_dword((uint32_t*)200, val);
+    }
+    /* Nothing was erased or copied inside the write */
+    EXPECT_EQ(BANK_SEQUENCE(1), 1);
+    EXPECT_EQ(BANK_STATE(1), 0xFFFF);
+    EXPECT_NE(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + HEADER_SIZE + 150], 0xFFFF);
+    /* Values are read across both banks */
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)150), 0xd00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), val);
+    /* Writes to words that haven't been migrated yet */
+    eeprom_write_byte((uint8_t*)151, 0x3c);
+    eeprom_write_word((uint16_t*)152, 0);
+    eeprom_write_word((uint16_t*)154, 0x1234);
+    /* Resume after reset */
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)150), 0x3c0d);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)152), 0);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)154), 0x1234);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)(EEPROM_SIZE - 2)), 0xf00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), val);
+    /* Finish in the background */
+    EXPECT_TRUE(EEPROM_Task());
+    while (EEPROM_Task()) {
+    }
+    EXPECT_EQ(BANK_STATE(1), 0);
+    EXPECT_TRUE(bank_is_blank(0));
+    EEPROM_Init();
+    EXPECT_FALSE(EEPROM_Task());
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)150), 0x3c0d);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)152), 0);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)154), 0x1234);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)(EEPROM_SIZE - 2)), 0xf00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), val);
+}
+
+TEST_F(EepromStm32Test, TestSwapRoundTrip) {
+    uint8_t  expected[EEPROM_SIZE] = {0};
+    uint32_t val                   = 0x8f2c3e51;
+    /* Enough writes to go around both banks several times */
+    for (uint32_t i = 0; i < LOG_SIZE * 4; i++) {
+        val ^= val << 13;
+        val ^= val >> 17;
+        val ^= val << 5;
+        uint16_t address = val % EEPROM_SIZE;
+        uint8_t  value   = (val >> 16) % 3 ? (val >> 24) : 0;
+        eeprom_write_byte((uint8_t*)(uintptr_t)address, value);
+        expected[address] = value;
+        /* Sometimes let the background work catch up */
+        if ((val >> 8) % 4 == 0) EEPROM_Task();
+        if ((val >> 8) % 97 == 0) EEPROM_Init();
+    }
+    for (uint16_t address = 0; address < EEPROM_SIZE; address++) {
+        EXPECT_EQ(EEPROM_ReadDataByte(address), expected[address]) << "address " << address;
+    }
+    EEPROM_Init();
+    while (EEPROM_Task()) {
+    }
+    int active = BANK_MAGIC(1) == 0x5EE9 ? 1 : 0;
+    EXPECT_GE(BANK_SEQUENCE(active), 3);
+    EXPECT_TRUE(bank_is_blank(!active));
+    EEPROM_Init();
+    for (uint16_t address = 0; address < EEPROM_SIZE; address++) {
+        EXPECT_EQ(EEPROM_ReadDataByte(address), expected[address]) << "address " << address;
+    }
+}
+#endif
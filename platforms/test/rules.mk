@@ -9,11 +9,29 @@ eeprom_stm32_large_DEFS := $(eeprom_stm32_DEFS) \
 	-DMOCK_FLASH_SIZE=65536 \
 	-DFEE_PAGE_SIZE=2048 \
 	-DFEE_PAGE_COUNT=16
+eeprom_stm32_swap_tiny_DEFS := $(eeprom_stm32_DEFS) \
+	-DFEE_PAGE_SWAPPING \
+	-DFEE_MCU_FLASH_SIZE=1 \
+	-DMOCK_FLASH_SIZE=1024 \
+	-DFEE_PAGE_SIZE=512 \
+	-DFEE_PAGE_COUNT=2 \
+	-DFEE_CACHE_SIZE=8
+eeprom_stm32_swap_tiny_mirror_DEFS := $(eeprom_stm32_swap_tiny_DEFS) \
+	-DFEE_MIRROR_MAX_BYTES=4096
+eeprom_stm32_swap_large_DEFS := $(eeprom_stm32_DEFS) \
+	-DFEE_PAGE_SWAPPING \
+	-DFEE_MCU_FLASH_SIZE=64 \
+	-DMOCK_FLASH_SIZE=65536 \
+	-DFEE_PAGE_SIZE=2048 \
+	-DFEE_PAGE_COUNT=16
 
 eeprom_stm32_INC := \
 	$(PLATFORM_PATH)/chibios/
 eeprom_stm32_tiny_INC := $(eeprom_stm32_INC)
 eeprom_stm32_large_INC := $(eeprom_stm32_INC)
+eeprom_stm32_swap_tiny_INC := $(eeprom_stm32_INC)
+eeprom_stm32_swap_tiny_mirror_INC := $(eeprom_stm32_INC)
+eeprom_stm32_swap_large_INC := $(eeprom_stm32_INC)
 
 eeprom_stm32_SRC := \
 	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
@@ -22,3 +40,11 @@ eeprom_stm32_SRC := \
 	$(PLATFORM_PATH)/chibios/eeprom_stm32.c
 eeprom_stm32_tiny_SRC := $(eeprom_stm32_SRC)
 eeprom_stm32_large_SRC := $(eeprom_stm32_SRC)
+eeprom_stm32_swap_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_stm32_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/flash_stm32_mock.c \
+	$(PLATFORM_PATH)/chibios/eeprom_stm32_swap.c
+eeprom_stm32_swap_tiny_SRC := $(eeprom_stm32_swap_SRC)
+eeprom_stm32_swap_tiny_mirror_SRC := $(eeprom_stm32_swap_SRC)
+eeprom_stm32_swap_large_SRC := $(eeprom_stm32_swap_SRC)
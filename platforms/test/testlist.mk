@@ -1 +1 @@
-TEST_LIST += eeprom_stm32_tiny eeprom_stm32_large
+TEST_LIST += eeprom_stm32_tiny eeprom_stm32_large eeprom_stm32_swap_tiny eeprom_stm32_swap_tiny_mirror eeprom_stm32_swap_large
@@ -10,6 +10,114 @@
 #    include "nodebug.h"
 #endif
 
+#include "keymap.h"
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+#    define LAYER_LOOKUP_INVALID 0xFF
+
+/** \brief layer lookup cache
+ *
+ * The layer which provides the action of each key, and the keycode found there, for the current layer state.
+ * Entries are resolved lazily, and only invalidated when a layer change can affect them.
+ */
+static uint8_t  layer_lookup_layers[MATRIX_ROWS][MATRIX_COLS];
+static uint16_t layer_lookup_keycodes[MATRIX_ROWS][MATRIX_COLS];
+static bool     layer_lookup_initialized = false;
+
+/** \brief Layer lookup cache clear
+ *
+ * Invalidates every cached entry. Must be called whenever the keymap itself changes.
+ */
+void layer_lookup_cache_clear(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            layer_lookup_layers[row][col] = LAYER_LOOKUP_INVALID;
+        }
+    }
+    layer_lookup_initialized = true;
+}
+
+/** \brief Layer lookup cache update
+ *
+ * Invalidates the entries affected by a change of the active layers. A key resolved to layer N is only
+ * affected if layer N was turned off, or if a layer above N was turned on.
+ */
+static void layer_lookup_cache_update(layer_state_t from, layer_state_t to) {
+    layer_state_t turned_on  = to & ~from;
+    layer_state_t turned_off = from & ~to;
+
+    if (!layer_lookup_initialized || !(turned_on | turned_off)) {
+        return;
+    }
+
+    uint8_t highest_on = turned_on ? get_highest_layer(turned_on) : 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t layer = layer_lookup_layers[row][col];
+            if (layer == LAYER_LOOKUP_INVALID) {
+                continue;
+            }
+            if ((turned_off & ((layer_state_t)1 << layer)) || (turned_on && layer < highest_on)) {
+                layer_lookup_layers[row][col] = LAYER_LOOKUP_INVALID;
+            }
+        }
+    }
+}
+
+/** \brief Layer lookup
+ *
+ * Returns the layer providing the action for a key, resolving and caching it if needed.
+ * The keycode found on that layer is stored in keycode.
+ */
+static uint8_t layer_lookup(keypos_t key, uint16_t *keycode) {
+    if (!layer_lookup_initialized) {
+        layer_lookup_cache_clear();
+    }
+
+    uint8_t layer = layer_lookup_layers[key.row][key.col];
+    if (layer == LAYER_LOOKUP_INVALID) {
+        layer_state_t layers = layer_state | default_layer_state;
+        uint16_t      found  = KC_TRANSPARENT;
+        /* check top layer first */
+        for (layer = MAX_LAYER - 1; layer > 0; layer--) {
+            if (layers & ((layer_state_t)1 << layer)) {
+                found = keymap_key_to_keycode(layer, key);
+                if (action_for_keycode(found).code != ACTION_TRANSPARENT) {
+                    break;
+                }
+            }
+        }
+        /* fall back to layer 0 */
+        if (layer == 0) {
+            found = keymap_key_to_keycode(0, key);
+        }
+        layer_lookup_layers[key.row][key.col]   = layer;
+        layer_lookup_keycodes[key.row][key.col] = found;
+    }
+
+    *keycode = layer_lookup_keycodes[key.row][key.col];
+    return layer;
+}
+
+/** \brief Is cacheable
+ *
+ * Only real matrix positions are cached, not the pseudo keys used by combos and the like.
+ */
+static inline bool layer_lookup_is_cacheable(keypos_t key) { return key.row < MATRIX_ROWS && key.col < MATRIX_COLS; }
+
+/** \brief Layer lookup keycode
+ *
+ * Returns the keycode of a key on a layer, from the cache when that layer is the one resolved for the key,
+ * so that the keymap (possibly in EEPROM) isn't read again for every event.
+ */
+uint16_t layer_lookup_keycode(uint8_t layer, keypos_t key) {
+    if (layer_lookup_initialized && layer_lookup_is_cacheable(key) && layer_lookup_layers[key.row][key.col] == layer) {
+        return layer_lookup_keycodes[key.row][key.col];
+    }
+    return keymap_key_to_keycode(layer, key);
+}
+#endif
+
 /** \brief Default Layer State
  */
 layer_state_t default_layer_state = 0;
@@ -35,6 +143,9 @@ static void default_layer_state_set(layer_state_t state) {
     debug("default_layer_state: ");
     default_layer_debug();
     debug(" to ");
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_update(layer_state | default_layer_state, layer_state | state);
+#endif
     default_layer_state = state;
     default_layer_debug();
     debug("\n");
@@ -101,6 +212,9 @@ void layer_state_set(layer_state_t state) {
     dprint("layer_state: ");
     layer_debug();
     dprint(" to ");
+#    ifdef LAYER_LOOKUP_CACHE
+    layer_lookup_cache_update(layer_state | default_layer_state, state | default_layer_state);
+#    endif
     layer_state = state;
     layer_debug();
     dprintln();
@@ -237,6 +351,9 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
     if (pressed) {
         layer = layer_switch_get_layer(key);
         update_source_layers_cache(key, layer);
+#    ifdef LAYER_LOOKUP_CACHE
+        return layer_switch_get_action(key);
+#    endif
     } else {
         layer = read_source_layers_cache(key);
     }
@@ -252,6 +369,12 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
  */
 uint8_t layer_switch_get_layer(keypos_t key) {
 #ifndef NO_ACTION_LAYER
+#    ifdef LAYER_LOOKUP_CACHE
+    if (layer_lookup_is_cacheable(key)) {
+        uint16_t keycode;
+        return layer_lookup(key, &keycode);
+    }
+#    endif
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
@@ -276,4 +399,13 @@ uint8_t layer_switch_get_layer(keypos_t key) {
  *
  * Gets action code based on key position
  */
-action_t layer_switch_get_action(keypos_t key) { return action_for_key(layer_switch_get_layer(key), key); }
+action_t layer_switch_get_action(keypos_t key) {
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    if (layer_lookup_is_cacheable(key)) {
+        uint16_t keycode;
+        layer_lookup(key, &keycode);
+        return action_for_keycode(keycode);
+    }
+#endif
+    return action_for_key(layer_switch_get_layer(key), key);
+}
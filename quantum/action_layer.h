@@ -132,6 +132,15 @@ layer_state_t layer_state_set_kb(layer_state_t state);
 #    define layer_state_set_user(state) (void)state
 #endif
 
+/* resolved layer lookup cache */
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+void     layer_lookup_cache_clear(void);
+uint16_t layer_lookup_keycode(uint8_t layer, keypos_t key);
+#else
+#    define layer_lookup_cache_clear()
+#    define layer_lookup_keycode(layer, key) keymap_key_to_keycode(layer, key)
+#endif
+
 /* pressed actions cache */
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
 
@@ -279,7 +279,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     tapping_key = *keyp;
                     debug_tapping_key();
                     return true;
-                } else if (is_tap_record(keyp) && event.pressed) {
+                } else if (event.pressed && is_tap_record(keyp)) {
                     if (tapping_key.tap.count > 1) {
                         debug("Tapping: Start new tap with releasing last tap(>1).\n");
                         // unregister key
@@ -325,7 +325,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     process_record(keyp);
                     tapping_key = (keyrecord_t){};
                     return true;
-                } else if (is_tap_record(keyp) && event.pressed) {
+                } else if (event.pressed && is_tap_record(keyp)) {
                     if (tapping_key.tap.count > 1) {
                         debug("Tapping: Start new tap with releasing last timeout tap(>1).\n");
                         // unregister key
@@ -0,0 +1,177 @@
+/*
+Copyright 2017 Alex Ong<the.onga@gmail.com>
+Copyright 2020 Andrei Purdea<andrei@purdea.ro>
+Copyright 2021 Simon Arlott
+Copyright 2022 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Basic symmetric per-key algorithm, behaving exactly like sym_defer_pk.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+
+The per-key counters are stored as vertical counters: bit-plane n of a row holds bit n
+of the counter of every key in that row. Each row is then counted down and compared using
+a handful of word-wide operations, instead of one loop iteration per key.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+// Number of bit-planes needed to hold a counter value of DEBOUNCE
+#if DEBOUNCE < 2
+#    define DEBOUNCE_PLANES 1
+#elif DEBOUNCE < 4
+#    define DEBOUNCE_PLANES 2
+#elif DEBOUNCE < 8
+#    define DEBOUNCE_PLANES 3
+#elif DEBOUNCE < 16
+#    define DEBOUNCE_PLANES 4
+#elif DEBOUNCE < 32
+#    define DEBOUNCE_PLANES 5
+#elif DEBOUNCE < 64
+#    define DEBOUNCE_PLANES 6
+#elif DEBOUNCE < 128
+#    define DEBOUNCE_PLANES 7
+#else
+#    define DEBOUNCE_PLANES 8
+#endif
+
+// Broadcast bit n of a scalar value to every column of a row
+#define PLANE_MASK(value, n) ((((value) >> (n)) & 1) ? (matrix_row_t)~(matrix_row_t)0 : (matrix_row_t)0)
+
+#if DEBOUNCE > 0
+static matrix_row_t debounce_counters[MATRIX_ROWS][DEBOUNCE_PLANES];
+static fast_timer_t last_time;
+static bool         counters_need_update;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t r = 0; r < num_rows; r++) {
+        for (uint8_t p = 0; p < DEBOUNCE_PLANES; p++) {
+            debounce_counters[r][p] = 0;
+        }
+    }
+    counters_need_update = false;
+}
+
+void debounce_free(void) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+
+    // No counter can hold more than DEBOUNCE, so anything longer expires them all the same way
+    if (elapsed_time > DEBOUNCE) {
+        elapsed_time = DEBOUNCE;
+    }
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t *counter = debounce_counters[row];
+        matrix_row_t  active  = 0;
+        for (uint8_t p = 0; p < DEBOUNCE_PLANES; p++) {
+            active |= counter[p];
+        }
+        if (!active) {
+            continue;
+        }
+
+        // Ripple-borrow subtraction of elapsed_time from every counter in the row
+        matrix_row_t borrow    = 0;
+        matrix_row_t remaining = 0;
+        for (uint8_t p = 0; p < DEBOUNCE_PLANES; p++) {
+            matrix_row_t subtrahend = PLANE_MASK(elapsed_time, p);
+            matrix_row_t difference = counter[p] ^ subtrahend ^ borrow;
+
+            borrow     = (~counter[p] & (subtrahend | borrow)) | (counter[p] & subtrahend & borrow);
+            counter[p] = difference;
+            remaining |= difference;
+        }
+
+        // A counter has expired if it was less than or equal to elapsed_time
+        matrix_row_t expired = active & (borrow | ~remaining);
+        matrix_row_t running = active & ~expired;
+        for (uint8_t p = 0; p < DEBOUNCE_PLANES; p++) {
+            counter[p] &= running;
+        }
+
+        cooked[row] = (cooked[row] & ~expired) | (raw[row] & expired);
+        if (running) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t *counter = debounce_counters[row];
+        matrix_row_t  delta   = raw[row] ^ cooked[row];
+        matrix_row_t  active  = 0;
+        for (uint8_t p = 0; p < DEBOUNCE_PLANES; p++) {
+            active |= counter[p];
+        }
+
+        // Keys which changed keep a running counter or start a new one, all others are reset
+        matrix_row_t start = delta & ~active;
+        for (uint8_t p = 0; p < DEBOUNCE_PLANES; p++) {
+            counter[p] = (counter[p] & delta) | (start & PLANE_MASK(DEBOUNCE, p));
+        }
+        if (delta) {
+            counters_need_update = true;
+        }
+    }
+}
+
+bool debounce_active(void) { return true; }
+#else
+#    include "none.c"
+#endif
@@ -81,6 +81,27 @@
 #    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
 #endif
 
+#ifndef MIN
+#    define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+// Size of the RAM buffer macros are read into from EEPROM before being sent.
+#ifndef DYNAMIC_KEYMAP_MACRO_READ_SIZE
+#    define DYNAMIC_KEYMAP_MACRO_READ_SIZE 32
+#endif
+#if DYNAMIC_KEYMAP_MACRO_READ_SIZE < 2
+#    error DYNAMIC_KEYMAP_MACRO_READ_SIZE must be at least 2
+#endif
+
+#define DYNAMIC_KEYMAP_MACRO_INVALID_OFFSET 0xFFFF
+
+// Start offset of each macro within the macro buffer, followed by the offset just past the last one.
+// Rebuilt on first use after the buffer changes, so that sending a macro doesn't need to scan for it.
+static uint16_t macro_offsets[DYNAMIC_KEYMAP_MACRO_COUNT + 1];
+static bool     macro_offsets_valid = false;
+// Whether the last byte of the buffer was zero when the offsets were built
+static bool macro_buffer_terminated = false;
+
 uint8_t dynamic_keymap_get_layer_count(void) { return DYNAMIC_KEYMAP_LAYER_COUNT; }
 
 void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) {
@@ -96,13 +117,18 @@ uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column)
     return keycode;
 }
 
-void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+static void dynamic_keymap_write_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
 }
 
+void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    dynamic_keymap_write_keycode(layer, row, column, keycode);
+    layer_lookup_cache_clear();
+}
+
 void dynamic_keymap_reset(void) {
     // Reset the keymaps in EEPROM to what is in flash.
     // All keyboards using dynamic keymaps should define a layout
@@ -110,10 +136,11 @@ void dynamic_keymap_reset(void) {
     for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
         for (int row = 0; row < MATRIX_ROWS; row++) {
             for (int column = 0; column < MATRIX_COLS; column++) {
-                dynamic_keymap_set_keycode(layer, row, column, pgm_read_word(&keymaps[layer][row][column]));
+                dynamic_keymap_write_keycode(layer, row, column, pgm_read_word(&keymaps[layer][row][column]));
             }
         }
     }
+    layer_lookup_cache_clear();
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
@@ -142,6 +169,7 @@ void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
         source++;
         target++;
     }
+    layer_lookup_cache_clear();
 }
 
 // This overrides the one in quantum/keymap_common.c
@@ -181,6 +209,7 @@ void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *da
         source++;
         target++;
     }
+    macro_offsets_valid = false;
 }
 
 void dynamic_keymap_macro_reset(void) {
@@ -190,6 +219,33 @@ void dynamic_keymap_macro_reset(void) {
         eeprom_update_byte(p, 0);
         ++p;
     }
+    macro_offsets_valid = false;
+}
+
+static void dynamic_keymap_macro_build_offsets(void) {
+    uint8_t  buffer[DYNAMIC_KEYMAP_MACRO_READ_SIZE];
+    uint8_t  id     = 0;
+    uint16_t offset = 0;
+
+    macro_offsets[0] = 0;
+    // Each null character ends a macro, so the next one starts just after it
+    while (id < DYNAMIC_KEYMAP_MACRO_COUNT && offset < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
+        uint16_t size = MIN(sizeof(buffer), DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - offset);
+        eeprom_read_block(buffer, (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset), size);
+        for (uint16_t i = 0; i < size && id < DYNAMIC_KEYMAP_MACRO_COUNT; i++) {
+            if (buffer[i] == 0) {
+                macro_offsets[++id] = offset + i + 1;
+            }
+        }
+        offset += size;
+    }
+    // If there weren't DYNAMIC_KEYMAP_MACRO_COUNT nulls in the buffer, the remaining macros don't exist
+    while (id < DYNAMIC_KEYMAP_MACRO_COUNT) {
+        macro_offsets[++id] = DYNAMIC_KEYMAP_MACRO_INVALID_OFFSET;
+    }
+
+    macro_buffer_terminated = eeprom_read_byte((void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1)) == 0;
+    macro_offsets_valid     = true;
 }
 
 void dynamic_keymap_macro_send(uint8_t id) {
@@ -197,54 +253,54 @@ void dynamic_keymap_macro_send(uint8_t id) {
         return;
     }
 
+    if (!macro_offsets_valid) {
+        dynamic_keymap_macro_build_offsets();
+    }
+
     // Check the last byte of the buffer.
     // If it's not zero, then we are in the middle
     // of buffer writing, possibly an aborted buffer
     // write. So do nothing.
-    void *p = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1);
-    if (eeprom_read_byte(p) != 0) {
+    if (!macro_buffer_terminated) {
         return;
     }
 
-    // Skip N null characters
-    // p will then point to the Nth macro
-    p         = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-    void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
-    while (id > 0) {
-        // If we are past the end of the buffer, then the buffer
-        // contents are garbage, i.e. there were not DYNAMIC_KEYMAP_MACRO_COUNT
-        // nulls in the buffer.
-        if (p == end) {
-            return;
-        }
-        if (eeprom_read_byte(p) == 0) {
-            --id;
-        }
-        ++p;
+    // The end of the Nth macro is the start of the next, less its null terminator.
+    // If the buffer contents are garbage, i.e. there were not enough nulls in
+    // the buffer, then this macro doesn't exist.
+    uint16_t offset = macro_offsets[id];
+    if (macro_offsets[id + 1] == DYNAMIC_KEYMAP_MACRO_INVALID_OFFSET) {
+        return;
     }
+    uint16_t end = macro_offsets[id + 1] - 1;
 
-    // Send the macro string one or three chars at a time
-    // by making temporary 1 or 3 char strings
-    char data[4] = {0, 0, 0, 0};
-    // We already checked there was a null at the end of
-    // the buffer, so this cannot go past the end
-    while (1) {
-        data[0] = eeprom_read_byte(p++);
-        data[1] = 0;
-        // Stop at the null terminator of this macro string
-        if (data[0] == 0) {
-            break;
-        }
-        // If the char is magic (tap, down, up),
-        // add the next char (key to use) and send a 3 char string.
-        if (data[0] == SS_TAP_CODE || data[0] == SS_DOWN_CODE || data[0] == SS_UP_CODE) {
-            data[1] = data[0];
-            data[0] = SS_QMK_PREFIX;
-            data[2] = eeprom_read_byte(p++);
-            if (data[2] == 0) {
-                break;
+    // Read the macro string a block at a time, and send it with the magic
+    // chars (tap, down, up) expanded into their 3 char sequences; an odd sized
+    // block can hold one more plain char on top of its expanded pairs
+    uint8_t buffer[DYNAMIC_KEYMAP_MACRO_READ_SIZE];
+    char    data[(DYNAMIC_KEYMAP_MACRO_READ_SIZE * 3 + 1) / 2 + 1];
+    while (offset < end) {
+        uint16_t size = MIN(sizeof(buffer), end - offset);
+        eeprom_read_block(buffer, (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset), size);
+
+        uint16_t i = 0;
+        char *   p = data;
+        while (i < size) {
+            if (buffer[i] == SS_TAP_CODE || buffer[i] == SS_DOWN_CODE || buffer[i] == SS_UP_CODE) {
+                if (i + 1 == size) {
+                    // The key to use is in the next block, or missing at the end of the macro
+                    break;
+                }
+                *p++ = SS_QMK_PREFIX;
+                *p++ = buffer[i++];
             }
+            *p++ = buffer[i++];
+        }
+        if (i == 0) {
+            break;
         }
+        *p = 0;
         send_string(data);
+        offset += i;
     }
 }
@@ -39,12 +39,15 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
  */
 void eeconfig_init_quantum(void) {
 #if defined(EEPROM_DRIVER)
+    eeprom_driver_flush();
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
     eeprom_update_byte(EECONFIG_DEBUG, 0);
     eeprom_update_byte(EECONFIG_DEFAULT_LAYER, 0);
     default_layer_state = 0;
+    // Set directly rather than through the default layer hooks, so resolved keys need looking up again
+    layer_lookup_cache_clear();
     eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, 0);
     eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, 0);
     eeprom_update_byte(EECONFIG_MOUSEKEY_ACCEL, 0);
@@ -104,6 +107,7 @@ void eeconfig_enable(void) { eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_N
  */
 void eeconfig_disable(void) {
 #if defined(EEPROM_DRIVER)
+    eeprom_driver_flush();
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
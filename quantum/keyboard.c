@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "scan_profile.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -363,6 +364,91 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
+#ifndef MATRIX_EVENT_QUEUE_SIZE
+#    define MATRIX_EVENT_QUEUE_SIZE 32
+#endif
+#if MATRIX_EVENT_QUEUE_SIZE > 255
+#    error MATRIX_EVENT_QUEUE_SIZE must be at most 255
+#endif
+
+// Ring of matrix changes which have been detected but not yet processed
+static keyevent_t matrix_event_queue[MATRIX_EVENT_QUEUE_SIZE];
+static uint8_t    matrix_event_head  = 0;
+static uint8_t    matrix_event_count = 0;
+
+/** \brief matrix_event_enqueue
+ *
+ * Compares the current matrix state against what has already been queued, and queues every change found.
+ * All events detected by the same scan share the timestamp of that scan. If the queue is full, the remaining
+ * changes are left untouched and will be picked up by a subsequent scan.
+ */
+static void matrix_event_enqueue(void) {
+    static matrix_row_t matrix_prev[MATRIX_ROWS];
+    const uint16_t      scan_time = timer_read() | 1; /* time should not be 0 */
+    bool                printed   = false;
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_row_t matrix_row    = matrix_get_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) {
+            continue;
+        }
+#ifdef MATRIX_HAS_GHOST
+        if (has_ghost_in_row(r, matrix_row)) {
+            continue;
+        }
+#endif
+        if (debug_matrix && !printed) {
+            matrix_print();
+            printed = true;
+        }
+        matrix_row_t col_mask = 1;
+        for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
+            if (matrix_change & col_mask) {
+                if (matrix_event_count >= MATRIX_EVENT_QUEUE_SIZE) {
+                    return;
+                }
+                uint8_t tail             = (matrix_event_head + matrix_event_count) % MATRIX_EVENT_QUEUE_SIZE;
+                matrix_event_queue[tail] = (keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = scan_time};
+                matrix_event_count++;
+                // record a queued key
+                matrix_prev[r] ^= col_mask;
+            }
+        }
+    }
+}
+
+/** \brief matrix_event_process
+ *
+ * Drains queued matrix events, in the order they were detected, into the action and switch event handlers.
+ * At most QMK_KEYS_PER_SCAN events are processed per call if defined, otherwise the whole queue is drained.
+ *
+ * \return true if at least one event was processed
+ */
+static bool matrix_event_process(void) {
+    uint8_t keys_processed = 0;
+
+    while (matrix_event_count) {
+#ifdef QMK_KEYS_PER_SCAN
+        // only process "enough" keys, leave the rest queued for the next task call.
+        if (keys_processed >= QMK_KEYS_PER_SCAN) {
+            break;
+        }
+#endif
+        keyevent_t event  = matrix_event_queue[matrix_event_head];
+        matrix_event_head = (matrix_event_head + 1) % MATRIX_EVENT_QUEUE_SIZE;
+        matrix_event_count--;
+
+        if (should_process_keypress()) {
+            action_exec(event);
+        }
+        switch_events(event.key.row, event.key.col, event.pressed);
+        keys_processed++;
+    }
+
+    return keys_processed;
+}
+
 /** \brief Keyboard task: Do keyboard routine jobs
  *
  * Do routine keyboard jobs:
@@ -375,90 +461,55 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
  * This is repeatedly called as fast as possible.
  */
 void keyboard_task(void) {
-    static matrix_row_t matrix_prev[MATRIX_ROWS];
-    static uint8_t      led_status    = 0;
-    matrix_row_t        matrix_row    = 0;
-    matrix_row_t        matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
-    uint8_t keys_processed = 0;
-#endif
+    static uint8_t led_status = 0;
 #ifdef ENCODER_ENABLE
     bool encoders_changed = false;
 #endif
 
-    uint8_t matrix_changed = matrix_scan();
-    if (matrix_changed) last_matrix_activity_trigger();
-
-    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-        matrix_row    = matrix_get_row(r);
-        matrix_change = matrix_row ^ matrix_prev[r];
-        if (matrix_change) {
-#ifdef MATRIX_HAS_GHOST
-            if (has_ghost_in_row(r, matrix_row)) {
-                continue;
-            }
+#ifdef SCAN_PROFILE_ENABLE
+    uint32_t keyboard_task_start = scan_profile_ticks();
 #endif
-            if (debug_matrix) matrix_print();
-            matrix_row_t col_mask = 1;
-            for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
-                if (matrix_change & col_mask) {
-                    if (should_process_keypress()) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                    }
-                    // record a processed key
-                    matrix_prev[r] ^= col_mask;
+    uint8_t matrix_changed = 0;
 
-                    switch_events(r, c, (matrix_row & col_mask));
+    SCAN_PROFILE(SCAN_PROFILE_MATRIX_SCAN, matrix_changed = matrix_scan());
+    if (matrix_changed) last_matrix_activity_trigger();
 
-#ifdef QMK_KEYS_PER_SCAN
-                    // only jump out if we have processed "enough" keys.
-                    if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
-                }
-            }
+    SCAN_PROFILE(SCAN_PROFILE_ACTION_EXEC, {
+        matrix_event_enqueue();
+        if (!matrix_event_process()) {
+            // call with pseudo tick event when no real key event.
+            action_exec(TICK);
         }
-    }
-    // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
-    // we can get here with some keys processed now.
-    if (!keys_processed)
-#endif
-        action_exec(TICK);
-
-MATRIX_LOOP_END:
+    });
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
+    SCAN_PROFILE(SCAN_PROFILE_RGBLIGHT_TASK, rgblight_task());
 #endif
 
 #ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
+    SCAN_PROFILE(SCAN_PROFILE_LED_MATRIX_TASK, led_matrix_task());
 #endif
 #ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+    SCAN_PROFILE(SCAN_PROFILE_RGB_MATRIX_TASK, rgb_matrix_task());
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
 #    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
+    SCAN_PROFILE(SCAN_PROFILE_BACKLIGHT_TASK, backlight_task());
 #    endif
 #endif
 
 #ifdef ENCODER_ENABLE
-    encoders_changed = encoder_read();
+    SCAN_PROFILE(SCAN_PROFILE_ENCODER_READ, encoders_changed = encoder_read());
     if (encoders_changed) last_encoder_activity_trigger();
 #endif
 
 #ifdef OLED_ENABLE
-    oled_task();
+    SCAN_PROFILE(SCAN_PROFILE_OLED_TASK, oled_task());
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
@@ -470,7 +521,7 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef ST7565_ENABLE
-    st7565_task();
+    SCAN_PROFILE(SCAN_PROFILE_ST7565_TASK, st7565_task());
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
@@ -483,19 +534,19 @@ MATRIX_LOOP_END:
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
+    SCAN_PROFILE(SCAN_PROFILE_MOUSEKEY_TASK, mousekey_task());
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
-    ps2_mouse_task();
+    SCAN_PROFILE(SCAN_PROFILE_PS2_MOUSE_TASK, ps2_mouse_task());
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
-    pointing_device_task();
+    SCAN_PROFILE(SCAN_PROFILE_POINTING_DEVICE_TASK, pointing_device_task());
 #endif
 
 #ifdef MIDI_ENABLE
-    midi_task();
+    SCAN_PROFILE(SCAN_PROFILE_MIDI_TASK, midi_task());
 #endif
 
 #ifdef VELOCIKEY_ENABLE
@@ -505,15 +556,20 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef JOYSTICK_ENABLE
-    joystick_task();
+    SCAN_PROFILE(SCAN_PROFILE_JOYSTICK_TASK, joystick_task());
 #endif
 
 #ifdef DIGITIZER_ENABLE
-    digitizer_task();
+    SCAN_PROFILE(SCAN_PROFILE_DIGITIZER_TASK, digitizer_task());
 #endif
 
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-    programmable_button_send();
+    SCAN_PROFILE(SCAN_PROFILE_PROGRAMMABLE_BUTTON_SEND, programmable_button_send());
+#endif
+
+#ifdef FEE_PAGE_SWAPPING
+    // background flash page migration and erase
+    eeprom_driver_task();
 #endif
 
     // update LED
@@ -521,6 +577,11 @@ MATRIX_LOOP_END:
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+#ifdef SCAN_PROFILE_ENABLE
+    scan_profile_record(SCAN_PROFILE_KEYBOARD_TASK, scan_profile_ticks() - keyboard_task_start);
+    scan_profile_task();
+#endif
 }
 
 /** \brief keyboard set leds
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "debounce.h"
+#include "scan_profile.h"
 #include "quantum.h"
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
@@ -254,6 +255,151 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_INTERRUPT_SCAN
+#    ifndef MATRIX_INTERRUPT_SCAN_TIMEOUT
+#        define MATRIX_INTERRUPT_SCAN_TIMEOUT 1
+#    endif
+
+#    if defined(DIRECT_PINS)
+#        define MATRIX_INPUT_COUNT (ROWS_PER_HAND * MATRIX_COLS)
+#        define MATRIX_INPUT_PIN(i) (direct_pins[(i) / MATRIX_COLS][(i) % MATRIX_COLS])
+#    elif (DIODE_DIRECTION == COL2ROW)
+#        define MATRIX_INPUT_COUNT MATRIX_COLS
+#        define MATRIX_INPUT_PIN(i) (col_pins[i])
+#    elif (DIODE_DIRECTION == ROW2COL)
+#        define MATRIX_INPUT_COUNT ROWS_PER_HAND
+#        define MATRIX_INPUT_PIN(i) (row_pins[i])
+#    endif
+
+static void select_all(void) {
+#    if defined(DIRECT_PINS)
+    // Direct pins are always connected
+#    elif (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t x = 0; x < ROWS_PER_HAND; x++) {
+        select_row(x);
+    }
+#    elif (DIODE_DIRECTION == ROW2COL)
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        select_col(x);
+    }
+#    endif
+}
+
+static void unselect_all(void) {
+#    if defined(DIRECT_PINS)
+    // Direct pins are always connected
+#    elif (DIODE_DIRECTION == COL2ROW)
+    unselect_rows();
+#    elif (DIODE_DIRECTION == ROW2COL)
+    unselect_cols();
+#    endif
+}
+
+static bool any_input_low(void) {
+    for (uint8_t i = 0; i < MATRIX_INPUT_COUNT; i++) {
+        if (readMatrixPin(MATRIX_INPUT_PIN(i)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#    if defined(PROTOCOL_CHIBIOS) && PAL_USE_CALLBACKS
+static binary_semaphore_t matrix_wake_sem;
+
+static void matrix_wake_callback(void *arg) {
+    chSysLockFromISR();
+    chBSemSignalI(&matrix_wake_sem);
+    chSysUnlockFromISR();
+}
+
+// Line events are tracked by pad number, so a pad already used for events by another driver, or by an
+// earlier input, cannot also wake the matrix. Those inputs are still picked up when the wait times out.
+static bool matrix_wake_pad_free(uint8_t index) {
+    pin_t pin = MATRIX_INPUT_PIN(index);
+    if (pin == NO_PIN) {
+        return false;
+    }
+#        ifdef SOFT_SERIAL_PIN
+    if (PAL_PAD(pin) == PAL_PAD(SOFT_SERIAL_PIN)) {
+        return false;
+    }
+#        endif
+#        ifdef PS2_CLOCK_PIN
+    if (PAL_PAD(pin) == PAL_PAD(PS2_CLOCK_PIN)) {
+        return false;
+    }
+#        endif
+#        ifdef POINTING_DEVICE_MOTION_PIN
+    if (PAL_PAD(pin) == PAL_PAD(POINTING_DEVICE_MOTION_PIN)) {
+        return false;
+    }
+#        endif
+    for (uint8_t i = 0; i < index; i++) {
+        if (MATRIX_INPUT_PIN(i) != NO_PIN && PAL_PAD(MATRIX_INPUT_PIN(i)) == PAL_PAD(pin)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The events stay enabled from here on, an edge during a full scan only signals the semaphore
+static void matrix_wake_init(void) {
+    chBSemObjectInit(&matrix_wake_sem, true);
+    for (uint8_t i = 0; i < MATRIX_INPUT_COUNT; i++) {
+        if (matrix_wake_pad_free(i)) {
+            palEnableLineEvent(MATRIX_INPUT_PIN(i), PAL_EVENT_MODE_FALLING_EDGE);
+            palSetLineCallback(MATRIX_INPUT_PIN(i), matrix_wake_callback, NULL);
+        }
+    }
+}
+
+// Sleeps until an input is pulled low, or the timeout expires so the other keyboard tasks can run
+static bool wait_for_input_low(void) {
+    // Forget edges seen while scanning, then check for a key that went down before the reset
+    chBSemReset(&matrix_wake_sem, true);
+    return any_input_low() || chBSemWaitTimeout(&matrix_wake_sem, TIME_MS2I(MATRIX_INTERRUPT_SCAN_TIMEOUT)) == MSG_OK;
+}
+#    endif
+
+static bool matrix_keys_released(void) {
+#    ifdef SPLIT_KEYBOARD
+    matrix_row_t *cooked = matrix + thisHand;
+#    else
+    matrix_row_t *cooked = matrix;
+#    endif
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        if (raw_matrix[row] || cooked[row]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decides whether the matrix needs to be read row by row
+static bool matrix_scan_needed(void) {
+    // Keep scanning while a key is down or still debouncing
+    if (!matrix_keys_released()) {
+        return true;
+    }
+
+    // Otherwise select every output at once, so a single read of the inputs shows whether anything was pressed
+    select_all();
+    matrix_output_select_delay();
+    bool pressed = any_input_low();
+#    if defined(PROTOCOL_CHIBIOS) && PAL_USE_CALLBACKS
+    if (!pressed) {
+        pressed = wait_for_input_low();
+    }
+#    endif
+    unselect_all();
+    matrix_output_unselect_delay(0, pressed);
+    return pressed;
+}
+#else
+#    define matrix_scan_needed() true
+#endif  // MATRIX_INTERRUPT_SCAN
+
 void matrix_init(void) {
 #ifdef SPLIT_KEYBOARD
     split_pre_init();
@@ -295,6 +441,10 @@ void matrix_init(void) {
 
     debounce_init(ROWS_PER_HAND);
 
+#if defined(MATRIX_INTERRUPT_SCAN) && defined(PROTOCOL_CHIBIOS) && PAL_USE_CALLBACKS
+    matrix_wake_init();
+#endif
+
     matrix_init_quantum();
 
 #ifdef SPLIT_KEYBOARD
@@ -342,27 +492,29 @@ bool matrix_post_scan(void) {
 uint8_t matrix_scan(void) {
     matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
 
+    if (matrix_scan_needed()) {
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
-    // Set row, read cols
-    for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
-        matrix_read_cols_on_row(curr_matrix, current_row);
-    }
+        // Set row, read cols
+        for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
+            matrix_read_cols_on_row(curr_matrix, current_row);
+        }
 #elif (DIODE_DIRECTION == ROW2COL)
-    // Set col, read rows
-    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
-    for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
-        matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
-    }
+        // Set col, read rows
+        matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+        for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
+            matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
+        }
 #endif
+    }
 
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
 
 #ifdef SPLIT_KEYBOARD
-    debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+    SCAN_PROFILE(SCAN_PROFILE_DEBOUNCE, debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed));
     changed = (changed || matrix_post_scan());
 #else
-    debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    SCAN_PROFILE(SCAN_PROFILE_DEBOUNCE, debounce(raw_matrix, matrix, ROWS_PER_HAND, changed));
     matrix_scan_quantum();
 #endif
     return (uint8_t)changed;
@@ -1,6 +1,7 @@
 #include "quantum.h"
 #include "matrix.h"
 #include "debounce.h"
+#include "scan_profile.h"
 #include "wait.h"
 #include "print.h"
 #include "debug.h"
@@ -112,7 +113,7 @@ __attribute__((weak)) void matrix_init(void) {
 __attribute__((weak)) uint8_t matrix_scan(void) {
     bool changed = matrix_scan_custom(raw_matrix);
 
-    debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+    SCAN_PROFILE(SCAN_PROFILE_DEBOUNCE, debounce(raw_matrix, matrix, MATRIX_ROWS, changed));
 
     matrix_scan_quantum();
     return changed;
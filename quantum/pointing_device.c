@@ -24,11 +24,131 @@
 #if (defined(POINTING_DEVICE_ROTATION_90) + defined(POINTING_DEVICE_ROTATION_180) + defined(POINTING_DEVICE_ROTATION_270)) > 1
 #    error More than one rotation selected.  This is not supported.
 #endif
+#ifdef POINTING_DEVICE_ASYNC_READ
+#    ifndef PROTOCOL_CHIBIOS
+#        error "POINTING_DEVICE_ASYNC_READ is only supported on ChibiOS"
+#    endif
+#    if defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c) || defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_spi)
+#        error "POINTING_DEVICE_ASYNC_READ is not supported by the Cirque driver, it sends reports from get_report"
+#    endif
+#    include <ch.h>
+#    ifndef POINTING_DEVICE_ASYNC_READ_STACK_SIZE
+#        define POINTING_DEVICE_ASYNC_READ_STACK_SIZE 512
+#    endif
+#    ifndef POINTING_DEVICE_ASYNC_READ_INTERVAL_US
+#        define POINTING_DEVICE_ASYNC_READ_INTERVAL_US 1000
+#    endif
+#endif
 
 static report_mouse_t mouseReport = {};
 
 extern const pointing_device_driver_t pointing_device_driver;
 
+#ifdef POINTING_DEVICE_MOTION_PIN
+// Motion too fast for one report is carried over by the driver after the sensor has released the motion pin,
+// so a report at the limit of its range is followed by another read without waiting for the pin
+static inline bool pointing_device_report_saturated(report_mouse_t report) {
+    return report.x == MOUSE_REPORT_XY_MIN || report.x == MOUSE_REPORT_XY_MAX || report.y == MOUSE_REPORT_XY_MIN || report.y == MOUSE_REPORT_XY_MAX;
+}
+#endif
+
+#ifdef POINTING_DEVICE_ASYNC_READ
+// Motion read by the sensor thread and not yet taken by pointing_device_task(), guarded by the system lock
+static int32_t pointing_async_x, pointing_async_y, pointing_async_v, pointing_async_h;
+static uint8_t pointing_async_buttons;
+// Serialises the sensor thread and the main loop's cpi calls on the sensor's bus
+static MUTEX_DECL(pointing_driver_mtx);
+static THD_WORKING_AREA(waPointingReadThread, POINTING_DEVICE_ASYNC_READ_STACK_SIZE);
+#    if defined(POINTING_DEVICE_MOTION_PIN) && PAL_USE_CALLBACKS
+static BSEMAPHORE_DECL(pointing_motion_sem, true);
+
+static void pointing_motion_callback(void *arg) {
+    chSysLockFromISR();
+    chBSemSignalI(&pointing_motion_sem);
+    chSysUnlockFromISR();
+}
+#    endif
+
+static THD_FUNCTION(PointingReadThread, arg) {
+    (void)arg;
+    chRegSetThreadName("pointing_read");
+
+    report_mouse_t sensor_report = {};
+#    ifdef POINTING_DEVICE_MOTION_PIN
+    bool saturated = false;
+#    endif
+
+    while (true) {
+#    ifdef POINTING_DEVICE_MOTION_PIN
+        // The motion pin stays low until the pending motion has been read
+        while (!saturated && readPin(POINTING_DEVICE_MOTION_PIN)) {
+#        if PAL_USE_CALLBACKS
+            chBSemWait(&pointing_motion_sem);
+#        else
+            chThdSleep(TIME_US2I(POINTING_DEVICE_ASYNC_READ_INTERVAL_US));
+#        endif
+        }
+#    endif
+
+        chMtxLock(&pointing_driver_mtx);
+        sensor_report = pointing_device_driver.get_report(sensor_report);
+        chMtxUnlock(&pointing_driver_mtx);
+#    ifdef POINTING_DEVICE_MOTION_PIN
+        saturated = pointing_device_report_saturated(sensor_report);
+#    endif
+
+        chSysLock();
+        pointing_async_x += sensor_report.x;
+        pointing_async_y += sensor_report.y;
+        pointing_async_v += sensor_report.v;
+        pointing_async_h += sensor_report.h;
+        pointing_async_buttons = sensor_report.buttons;
+        chSysUnlock();
+
+        sensor_report.x = 0;
+        sensor_report.y = 0;
+        sensor_report.v = 0;
+        sensor_report.h = 0;
+
+        chThdSleep(TIME_US2I(POINTING_DEVICE_ASYNC_READ_INTERVAL_US));
+    }
+}
+
+static void pointing_device_async_init(void) {
+#    if defined(POINTING_DEVICE_MOTION_PIN) && PAL_USE_CALLBACKS
+    palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_FALLING_EDGE);
+    palSetLineCallback(POINTING_DEVICE_MOTION_PIN, pointing_motion_callback, NULL);
+#    endif
+    chThdCreateStatic(waPointingReadThread, sizeof(waPointingReadThread), NORMALPRIO + 1, PointingReadThread, NULL);
+}
+
+// Takes as much of the accumulated motion as fits in one report, the rest is left for the next one
+static int32_t pointing_async_take_axis(int32_t *amount, int32_t min, int32_t max) {
+    int32_t taken = *amount < min ? min : (*amount > max ? max : *amount);
+    *amount -= taken;
+    return taken;
+}
+
+static report_mouse_t pointing_device_async_get_report(report_mouse_t mouse_report) {
+    static uint8_t last_buttons = 0;
+
+    chSysLock();
+    mouse_report.x  = pointing_async_take_axis(&pointing_async_x, MOUSE_REPORT_XY_MIN, MOUSE_REPORT_XY_MAX);
+    mouse_report.y  = pointing_async_take_axis(&pointing_async_y, MOUSE_REPORT_XY_MIN, MOUSE_REPORT_XY_MAX);
+    mouse_report.v  = pointing_async_take_axis(&pointing_async_v, -127, 127);
+    mouse_report.h  = pointing_async_take_axis(&pointing_async_h, -127, 127);
+    uint8_t buttons = pointing_async_buttons;
+    chSysUnlock();
+
+    // Only apply the buttons the driver changed, as a synchronous get_report would
+    uint8_t changed      = buttons ^ last_buttons;
+    mouse_report.buttons = (mouse_report.buttons & ~changed) | (buttons & changed);
+    last_buttons         = buttons;
+
+    return mouse_report;
+}
+#endif
+
 __attribute__((weak)) bool has_mouse_report_changed(report_mouse_t new, report_mouse_t old) { return memcmp(&new, &old, sizeof(new)); }
 
 __attribute__((weak)) void           pointing_device_init_kb(void) {}
@@ -52,6 +172,9 @@ __attribute__((weak)) void pointing_device_init(void) {
 #endif
     pointing_device_init_kb();
     pointing_device_init_user();
+#ifdef POINTING_DEVICE_ASYNC_READ
+    pointing_device_async_init();
+#endif
 }
 
 __attribute__((weak)) void pointing_device_send(void) {
@@ -72,14 +195,23 @@ __attribute__((weak)) void pointing_device_send(void) {
 
 __attribute__((weak)) void pointing_device_task(void) {
     // Gather report info
-#ifdef POINTING_DEVICE_MOTION_PIN
-    if (!readPin(POINTING_DEVICE_MOTION_PIN))
-#endif
+#ifdef POINTING_DEVICE_ASYNC_READ
+    mouseReport = pointing_device_async_get_report(mouseReport);
+#else
+#    ifdef POINTING_DEVICE_MOTION_PIN
+    static bool saturated = false;
+    if (saturated || !readPin(POINTING_DEVICE_MOTION_PIN)) {
         mouseReport = pointing_device_driver.get_report(mouseReport);
+        saturated   = pointing_device_report_saturated(mouseReport);
+    }
+#    else
+    mouseReport = pointing_device_driver.get_report(mouseReport);
+#    endif
+#endif
 
-        // Support rotation of the sensor data
+    // Support rotation of the sensor data
 #if defined(POINTING_DEVICE_ROTATION_90) || defined(POINTING_DEVICE_ROTATION_180) || defined(POINTING_DEVICE_ROTATION_270)
-    int8_t x = mouseReport.x, y = mouseReport.y;
+    mouse_xy_report_t x = mouseReport.x, y = mouseReport.y;
 #    if defined(POINTING_DEVICE_ROTATION_90)
     mouseReport.x = y;
     mouseReport.y = -x;
@@ -115,6 +247,21 @@ report_mouse_t pointing_device_get_report(void) { return mouseReport; }
 
 void pointing_device_set_report(report_mouse_t newMouseReport) { mouseReport = newMouseReport; }
 
+#ifdef POINTING_DEVICE_ASYNC_READ
+uint16_t pointing_device_get_cpi(void) {
+    chMtxLock(&pointing_driver_mtx);
+    uint16_t cpi = pointing_device_driver.get_cpi();
+    chMtxUnlock(&pointing_driver_mtx);
+    return cpi;
+}
+
+void pointing_device_set_cpi(uint16_t cpi) {
+    chMtxLock(&pointing_driver_mtx);
+    pointing_device_driver.set_cpi(cpi);
+    chMtxUnlock(&pointing_driver_mtx);
+}
+#else
 uint16_t pointing_device_get_cpi(void) { return pointing_device_driver.get_cpi(); }
 
 void pointing_device_set_cpi(uint16_t cpi) { pointing_device_driver.set_cpi(cpi); }
+#endif
@@ -22,8 +22,17 @@
 #include "timer.h"
 #include <stddef.h>
 
-// hid mouse reports cannot exceed -127 to 127, so constrain to that value
-#define constrain_hid(amt) ((amt) < -127 ? -127 : ((amt) > 127 ? 127 : (amt)))
+// hid mouse reports cannot exceed MOUSE_REPORT_XY_MIN to MOUSE_REPORT_XY_MAX, so constrain to that value
+#define constrain_hid_xy(amt) ((amt) < MOUSE_REPORT_XY_MIN ? MOUSE_REPORT_XY_MIN : ((amt) > MOUSE_REPORT_XY_MAX ? MOUSE_REPORT_XY_MAX : (amt)))
+
+// Adds the motion to what is still owed to the host and takes out as much as fits in one report.
+// Motion beyond the report range is sent over the following reports instead of being dropped.
+static inline mouse_xy_report_t carry_hid_xy(int32_t *carry, int16_t amt) {
+    *carry += amt;
+    mouse_xy_report_t report = constrain_hid_xy(*carry);
+    *carry -= report;
+    return report;
+}
 
 // get_report functions should probably be moved to their respective drivers.
 #if defined(POINTING_DEVICE_DRIVER_adns5050)
@@ -53,13 +62,11 @@ const pointing_device_driver_t pointing_device_driver = {
 #elif defined(POINTING_DEVICE_DRIVER_adns9800)
 
 report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
+    static int32_t    carry_x = 0, carry_y = 0;
     report_adns9800_t sensor_report = adns9800_get_report();
 
-    int8_t clamped_x = constrain_hid(sensor_report.x);
-    int8_t clamped_y = constrain_hid(sensor_report.y);
-
-    mouse_report.x = clamped_x;
-    mouse_report.y = clamped_y;
+    mouse_report.x = carry_hid_xy(&carry_x, sensor_report.x);
+    mouse_report.y = carry_hid_xy(&carry_y, sensor_report.y);
 
     return mouse_report;
 }
@@ -116,15 +123,15 @@ const pointing_device_driver_t pointing_device_driver = {
 
 report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
     pinnacle_data_t touchData = cirque_pinnacle_read_data();
-    static uint16_t x = 0, y = 0, mouse_timer = 0;
-    int8_t          report_x = 0, report_y = 0;
-    static bool     is_z_down = false;
+    static uint16_t   x = 0, y = 0, mouse_timer = 0;
+    mouse_xy_report_t report_x = 0, report_y = 0;
+    static bool       is_z_down = false;
 
     cirque_pinnacle_scale_data(&touchData, cirque_pinnacle_get_scale(), cirque_pinnacle_get_scale());  // Scale coordinates to arbitrary X, Y resolution
 
     if (x && y && touchData.xValue && touchData.yValue) {
-        report_x = (int8_t)(touchData.xValue - x);
-        report_y = (int8_t)(touchData.yValue - y);
+        report_x = (mouse_xy_report_t)(touchData.xValue - x);
+        report_y = (mouse_xy_report_t)(touchData.yValue - y);
     }
     x = touchData.xValue;
     y = touchData.yValue;
@@ -183,8 +190,12 @@ report_mouse_t pimorono_trackball_get_report(report_mouse_t mouse_report) {
                 if (!debounce) {
                     x_offset += pimoroni_trackball_get_offsets(pimoroni_data.right, pimoroni_data.left, PIMORONI_TRACKBALL_SCALE);
                     y_offset += pimoroni_trackball_get_offsets(pimoroni_data.down, pimoroni_data.up, PIMORONI_TRACKBALL_SCALE);
-                    pimoroni_trackball_adapt_values(&mouse_report.x, &x_offset);
-                    pimoroni_trackball_adapt_values(&mouse_report.y, &y_offset);
+                    // mouse_report is packed, so go through locals rather than pointing into it
+                    mouse_xy_report_t x, y;
+                    pimoroni_trackball_adapt_values(&x, &x_offset);
+                    pimoroni_trackball_adapt_values(&y, &y_offset);
+                    mouse_report.x = x;
+                    mouse_report.y = y;
                 } else {
                     debounce--;
                 }
@@ -215,6 +226,7 @@ static void init(void) { pmw3360_init(); }
 report_mouse_t pmw3360_get_report(report_mouse_t mouse_report) {
     report_pmw3360_t data        = pmw3360_read_burst();
     static uint16_t  MotionStart = 0;  // Timer for accel, 0 is resting state
+    static int32_t   carry_x = 0, carry_y = 0;
 
     if (data.isOnSurface && data.isMotion) {
         // Reset timer if stopped moving
@@ -230,8 +242,12 @@ report_mouse_t pmw3360_get_report(report_mouse_t mouse_report) {
 #    endif
             MotionStart = timer_read();
         }
-        mouse_report.x = constrain_hid(data.dx);
-        mouse_report.y = constrain_hid(data.dy);
+        mouse_report.x = carry_hid_xy(&carry_x, data.dx);
+        mouse_report.y = carry_hid_xy(&carry_y, data.dy);
+    } else if (carry_x || carry_y) {
+        // finish sending a movement that was too fast for the report
+        mouse_report.x = carry_hid_xy(&carry_x, 0);
+        mouse_report.y = carry_hid_xy(&carry_y, 0);
     }
 
     return mouse_report;
@@ -18,6 +18,15 @@
 #include "process_combo.h"
 #include "action_tapping.h"
 
+#ifdef COMBO_KEY_INDEX
+#    include <stdlib.h>
+#    ifdef PROTOCOL_CHIBIOS
+#        if CH_CFG_USE_MEMCORE == FALSE
+#            error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with COMBO_KEY_INDEX.
+#        endif
+#    endif
+#endif
+
 #ifdef COMBO_COUNT
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT];
 uint16_t                      COMBO_LEN = COMBO_COUNT;
@@ -237,6 +246,97 @@ static inline void _find_key_index_and_count(const uint16_t *keys, uint16_t keyc
     }
 }
 
+#ifdef COMBO_KEY_INDEX
+/* Inverted index from keycode to the combos using it, sorted by keycode
+ * and then by combo index, so that combos are still processed in order. */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+    uint8_t  key_index;
+    uint8_t  key_count;
+} combo_key_index_t;
+static combo_key_index_t *combo_key_index      = NULL;
+static uint16_t           combo_key_index_size = 0;
+static bool               combo_key_index_init = false;
+
+static int combo_key_index_compare(const void *a, const void *b) {
+    const combo_key_index_t *entry_a = a;
+    const combo_key_index_t *entry_b = b;
+
+    if (entry_a->keycode != entry_b->keycode) {
+        return entry_a->keycode < entry_b->keycode ? -1 : 1;
+    }
+    return entry_a->combo_index < entry_b->combo_index ? -1 : (entry_a->combo_index > entry_b->combo_index);
+}
+
+static void build_combo_key_index(void) {
+    combo_key_index_init = true;
+
+    uint16_t size = 0;
+    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+        const uint16_t *keys = key_combos[idx].keys;
+        while (pgm_read_word(keys++) != COMBO_END) {
+            size++;
+        }
+    }
+
+    combo_key_index = (combo_key_index_t *)malloc(size * sizeof(combo_key_index_t));
+    if (!combo_key_index) {
+        return;
+    }
+
+    combo_key_index_size = 0;
+    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+        const uint16_t *keys = key_combos[idx].keys;
+        uint8_t         key_count;
+        uint16_t        key;
+
+        for (key_count = 0; pgm_read_word(&keys[key_count]) != COMBO_END; ++key_count)
+            ;
+
+        for (uint8_t key_index = 0; key_index < key_count; ++key_index) {
+            key = pgm_read_word(&keys[key_index]);
+            // a key listed twice in a combo only counts once, at its last position
+            for (uint8_t i = key_index + 1; i < key_count; ++i) {
+                if (pgm_read_word(&keys[i]) == key) {
+                    key = COMBO_END;
+                    break;
+                }
+            }
+            if (key == COMBO_END) {
+                continue;
+            }
+
+            combo_key_index[combo_key_index_size++] = (combo_key_index_t){
+                .keycode     = key,
+                .combo_index = idx,
+                .key_index   = key_index,
+                .key_count   = key_count,
+            };
+        }
+    }
+
+    qsort(combo_key_index, combo_key_index_size, sizeof(combo_key_index_t), combo_key_index_compare);
+}
+
+/* Returns the position of the first index entry for keycode, or
+ * combo_key_index_size if no combo uses it. */
+static uint16_t find_combo_key_index(uint16_t keycode) {
+    uint16_t low  = 0;
+    uint16_t high = combo_key_index_size;
+
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (combo_key_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+#endif
+
 void drop_combo_from_buffer(uint16_t combo_index) {
     /* Mark a combo as processed from the buffer. If the buffer is in the
      * beginning of the buffer, drop it.  */
@@ -350,16 +450,7 @@ combo_t *overlaps(combo_t *combo1, combo_t *combo2) {
     return combo1;
 }
 
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
-    uint8_t  key_count = 0;
-    uint16_t key_index = -1;
-    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
-
-    /* Continue processing if key isn't part of current combo. */
-    if (-1 == (int16_t)key_index) {
-        return false;
-    }
-
+static bool process_combo_key(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index, uint16_t key_index, uint8_t key_count) {
     bool key_is_part_of_combo = !COMBO_DISABLED(combo) && is_combo_enabled();
 
     if (record->event.pressed && key_is_part_of_combo) {
@@ -463,9 +554,21 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     return key_is_part_of_combo;
 }
 
+static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
+    uint8_t  key_count = 0;
+    uint16_t key_index = -1;
+    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
+
+    /* Continue processing if key isn't part of current combo. */
+    if (-1 == (int16_t)key_index) {
+        return false;
+    }
+
+    return process_combo_key(combo, keycode, record, combo_index, key_index, key_count);
+}
+
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    bool no_combo_keys_pressed = true;
+    bool is_combo_key = false;
 
     if (keycode == CMB_ON && record->event.pressed) {
         combo_enable();
@@ -487,10 +590,27 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     keycode = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, record->event.key);
 #endif
 
-    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
-        combo_t *combo = &key_combos[idx];
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX
+    if (!combo_key_index_init) {
+        build_combo_key_index();
+    }
+
+    if (combo_key_index) {
+        /* Only visit the combos which contain this keycode. */
+        for (uint16_t i = find_combo_key_index(keycode); i < combo_key_index_size && combo_key_index[i].keycode == keycode; ++i) {
+            combo_key_index_t *entry = &combo_key_index[i];
+            is_combo_key |= process_combo_key(&key_combos[entry->combo_index], keycode, record, entry->combo_index, entry->key_index, entry->key_count);
+        }
+    } else
+#endif
+    {
+        /* No index (disabled, or it could not be allocated): scan every combo. */
+        bool no_combo_keys_pressed = true;
+        for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+            combo_t *combo = &key_combos[idx];
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+            no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -22,6 +22,15 @@
 
 #include <debug.h>
 
+#ifdef KEY_OVERRIDE_INDEX
+#    include <stdlib.h>
+#    ifdef PROTOCOL_CHIBIOS
+#        if CH_CFG_USE_MEMCORE == FALSE
+#            error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with KEY_OVERRIDE_INDEX.
+#        endif
+#    endif
+#endif
+
 #ifndef KEY_OVERRIDE_REPEAT_DELAY
 #    define KEY_OVERRIDE_REPEAT_DELAY 500
 #endif
@@ -241,14 +250,132 @@ static bool check_activation_event(const key_override_t *override, const bool ke
     }
 }
 
+#ifdef KEY_OVERRIDE_INDEX
+/* Indices into key_overrides, sorted by trigger keycode and then by index, so that overrides
+ * with the same trigger are still tried in the order they are listed. The overrides without a
+ * trigger key form the KC_NO bucket at the start. */
+static uint8_t               *key_override_index        = NULL;
+static uint8_t                key_override_index_size   = 0;
+static const key_override_t **key_override_index_source = NULL;
+
+static int key_override_index_compare(const void *a, const void *b) {
+    const uint8_t  index_a   = *(const uint8_t *)a;
+    const uint8_t  index_b   = *(const uint8_t *)b;
+    const uint16_t trigger_a = key_overrides[index_a]->trigger;
+    const uint16_t trigger_b = key_overrides[index_b]->trigger;
+
+    if (trigger_a != trigger_b) {
+        return trigger_a < trigger_b ? -1 : 1;
+    }
+    return index_a < index_b ? -1 : (index_a > index_b);
+}
+
+static void build_key_override_index(void) {
+    free(key_override_index);
+    key_override_index        = NULL;
+    key_override_index_size   = 0;
+    key_override_index_source = key_overrides;
+
+    if (key_overrides == NULL) {
+        return;
+    }
+
+    uint8_t size = 0;
+    while (key_overrides[size] != NULL) {
+        size++;
+    }
+
+    key_override_index = (uint8_t *)malloc(size ? size : 1);
+    if (!key_override_index) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < size; i++) {
+        key_override_index[i] = i;
+    }
+    key_override_index_size = size;
+
+    qsort(key_override_index, key_override_index_size, sizeof(uint8_t), key_override_index_compare);
+}
+
+/* The index entries [begin, end) of up to three trigger buckets, which are merged by override index. */
+typedef struct {
+    uint8_t begin[3];
+    uint8_t end[3];
+    uint8_t count;
+} key_override_buckets_t;
+
+static void add_key_override_bucket(key_override_buckets_t *buckets, const uint16_t trigger) {
+    uint8_t low  = 0;
+    uint8_t high = key_override_index_size;
+
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (key_overrides[key_override_index[mid]]->trigger < trigger) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    buckets->begin[buckets->count] = low;
+
+    while (low < key_override_index_size && key_overrides[key_override_index[low]]->trigger == trigger) {
+        low++;
+    }
+    buckets->end[buckets->count] = low;
+    buckets->count++;
+}
+
+/* An override can only activate if it has no trigger key, or if its trigger is the key of this event or the last non-mod key that was pressed down. */
+static void find_key_override_buckets(key_override_buckets_t *buckets, const uint16_t keycode) {
+    buckets->count = 0;
+    add_key_override_bucket(buckets, KC_NO);
+    if (keycode != KC_NO) {
+        add_key_override_bucket(buckets, keycode);
+    }
+    if (last_key_down != KC_NO && last_key_down != keycode) {
+        add_key_override_bucket(buckets, last_key_down);
+    }
+}
+
+/* Returns the candidate override listed first that has not been visited yet, or NULL once all have been. */
+static const key_override_t *next_key_override(key_override_buckets_t *buckets) {
+    int8_t next = -1;
+
+    for (uint8_t b = 0; b < buckets->count; b++) {
+        if (buckets->begin[b] < buckets->end[b] && (next < 0 || key_override_index[buckets->begin[b]] < key_override_index[buckets->begin[next]])) {
+            next = b;
+        }
+    }
+    if (next < 0) {
+        return NULL;
+    }
+
+    return key_overrides[key_override_index[buckets->begin[next]++]];
+}
+#endif
+
 /** Iterates through the list of key overrides and tries activating each, until it finds one that activates or reaches the end of overrides. Returns true if the key action for `keycode` should be sent */
 static bool try_activating_override(const uint16_t keycode, const uint8_t layer, const bool key_down, const bool is_mod, const uint8_t active_mods, bool *activated) {
     if (key_overrides == NULL) {
         return true;
     }
 
+#ifdef KEY_OVERRIDE_INDEX
+    if (key_override_index_source != key_overrides) {
+        build_key_override_index();
+    }
+
+    // Only visit the overrides which can be triggered by this event
+    key_override_buckets_t buckets;
+    find_key_override_buckets(&buckets, keycode);
+
+    for (uint8_t i = 0;; i++) {
+        const key_override_t *const override = key_override_index ? next_key_override(&buckets) : key_overrides[i];
+#else
     for (uint8_t i = 0;; i++) {
         const key_override_t *const override = key_overrides[i];
+#endif
 
         // End of array
         if (override == NULL) {
@@ -183,7 +183,22 @@ static void send_nibble_wrapper(uint8_t digit) {
 
 // clang-format on
 
+// Sends the same digits as send_nibble() as one string, so they can be packed
+static void send_hex_string(uint32_t hex, uint8_t digits) {
+    char str[9];
+    str[digits] = '\0';
+    for (uint8_t i = digits; i > 0; i--, hex >>= 4) {
+        uint8_t digit = hex & 0xF;
+        str[i - 1]    = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    }
+    send_string(str);
+}
+
 void register_hex(uint16_t hex) {
+    if (unicode_config.input_mode != UC_WIN) {
+        send_hex_string(hex, 4);
+        return;
+    }
     for (int i = 3; i >= 0; i--) {
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
         send_nibble_wrapper(digit);
@@ -191,6 +206,14 @@ void register_hex(uint16_t hex) {
 }
 
 void register_hex32(uint32_t hex) {
+    if (unicode_config.input_mode != UC_WIN) {
+        uint8_t digits = 8;
+        while (digits > 4 && ((hex >> ((digits - 1) * 4)) & 0xF) == 0) {
+            digits--;
+        }
+        send_hex_string(hex, digits);
+        return;
+    }
     bool onzerostart = true;
     for (int i = 7; i >= 0; i--) {
         if (i <= 3) {
@@ -16,6 +16,7 @@
 
 #include "quantum.h"
 #include "magic.h"
+#include "scan_profile.h"
 
 #ifdef BLUETOOTH_ENABLE
 #    include "outputselect.h"
@@ -37,6 +38,10 @@
 #    include "haptic.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -134,6 +139,9 @@ void reset_keyboard(void) {
 #endif
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
+#endif
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
 #endif
     bootloader_jump();
 }
@@ -166,17 +174,17 @@ uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
         } else {
             layer = read_source_layers_cache(event.key);
         }
-        return keymap_key_to_keycode(layer, event.key);
+        return layer_lookup_keycode(layer, event.key);
     } else
 #endif
-        return keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
+        return layer_lookup_keycode(layer_switch_get_layer(event.key), event.key);
 }
 
 /* Get keycode, and then process pre tapping functionality */
 bool pre_process_record_quantum(keyrecord_t *record) {
     if (!(
 #ifdef COMBO_ENABLE
-            process_combo(get_record_keycode(record, true), record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_COMBO, process_combo(get_record_keycode(record, true), record)) &&
 #endif
             true)) {
         return false;
@@ -190,6 +198,11 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
+/* Calls a handler only when the keycode lies within [min, max], the range of keycodes it acts upon,
+   and otherwise continues down the chain. The range check is a single unsigned comparison. */
+#define KEYCODE_IN_RANGE(min, max) ((uint16_t)(keycode - (min)) <= (uint16_t)((max) - (min)))
+#define PROCESS_KEYCODE_RANGE(min, max, ...) (!KEYCODE_IN_RANGE(min, max) || (__VA_ARGS__))
+
 /* Core keycode function, hands off handling to other functions,
     then processes internal quantum keycodes, and then processes
     ACTIONs.                                                      */
@@ -223,81 +236,85 @@ bool process_record_quantum(keyrecord_t *record) {
     if (!(
 #if defined(KEY_LOCK_ENABLE)
             // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_KEY_LOCK, process_key_lock(&keycode, record)) &&
 #endif
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
             // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_DYNAMIC_MACRO, process_dynamic_macro(keycode, record)) &&
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_CLICKY, process_clicky(keycode, record)) &&
 #endif
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_HAPTIC, process_haptic(keycode, record)) &&
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(FN_MO13, MACRO15, PROCESS_PROFILE(PROCESS_PROFILE_VIA, process_record_via(keycode, record))) &&
 #endif
-            process_record_kb(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_RECORD_KB, process_record_kb(keycode, record)) &&
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(SQ_ON, SEQUENCER_TRACK_MAX, PROCESS_PROFILE(PROCESS_PROFILE_SEQUENCER, process_sequencer(keycode, record))) &&
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(MIDI_TONE_MIN, MI_BENDU, PROCESS_PROFILE(PROCESS_PROFILE_MIDI, process_midi(keycode, record))) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(AU_ON, MUV_DE, PROCESS_PROFILE(PROCESS_PROFILE_AUDIO, process_audio(keycode, record))) &&
 #endif
 #if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
-            process_backlight(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(BL_ON, BL_BRTG, PROCESS_PROFILE(PROCESS_PROFILE_BACKLIGHT, process_backlight(keycode, record))) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(QK_STENO, QK_STENO_MAX, PROCESS_PROFILE(PROCESS_PROFILE_STENO, process_steno(keycode, record))) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_MUSIC, process_music(keycode, record)) &&
 #endif
 #ifdef KEY_OVERRIDE_ENABLE
-            process_key_override(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_KEY_OVERRIDE, process_key_override(keycode, record)) &&
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(QK_TAP_DANCE, QK_TAP_DANCE_MAX, PROCESS_PROFILE(PROCESS_PROFILE_TAP_DANCE, process_tap_dance(keycode, record))) &&
 #endif
-#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
+#if defined(UCIS_ENABLE)
+            // UCIS consumes every key while an input sequence is active.
+            PROCESS_PROFILE(PROCESS_PROFILE_UNICODE_COMMON, process_unicode_common(keycode, record)) &&
+#elif defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE)
+            // QK_UNICODE and QK_UNICODEMAP both extend to the top of the keycode space.
+            (!(keycode >= QK_UNICODE || KEYCODE_IN_RANGE(UNICODE_MODE_FORWARD, UNICODE_MODE_WINC)) || PROCESS_PROFILE(PROCESS_PROFILE_UNICODE_COMMON, process_unicode_common(keycode, record))) &&
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_LEADER, process_leader(keycode, record)) &&
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_PRINTER, process_printer(keycode, record)) &&
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_AUTO_SHIFT, process_auto_shift(keycode, record)) &&
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(DT_PRNT, DT_DOWN, PROCESS_PROFILE(PROCESS_PROFILE_DYNAMIC_TAPPING_TERM, process_dynamic_tapping_term(keycode, record))) &&
 #endif
 #ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_TERMINAL, process_terminal(keycode, record)) &&
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_SPACE_CADET, process_space_cadet(keycode, record)) &&
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_GUI, PROCESS_PROFILE(PROCESS_PROFILE_MAGIC, process_magic(keycode, record))) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(GRAVE_ESC, GRAVE_ESC, PROCESS_PROFILE(PROCESS_PROFILE_GRAVE_ESC, process_grave_esc(keycode, record))) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(RGB_TOG, RGB_MODE_TWINKLE, PROCESS_PROFILE(PROCESS_PROFILE_RGB, process_rgb(keycode, record))) &&
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+            PROCESS_PROFILE(PROCESS_PROFILE_JOYSTICK, process_joystick(keycode, record)) &&
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(PROGRAMMABLE_BUTTON_MIN, PROGRAMMABLE_BUTTON_MAX, PROCESS_PROFILE(PROCESS_PROFILE_PROGRAMMABLE_BUTTON, process_programmable_button(keycode, record))) &&
 #endif
             true)) {
         return false;
@@ -488,6 +505,11 @@ __attribute__((weak)) void suspend_power_down_user(void) {}
 __attribute__((weak)) void suspend_power_down_kb(void) { suspend_power_down_user(); }
 
 void suspend_power_down_quantum(void) {
+#ifdef EEPROM_DRIVER
+    // Commit deferred EEPROM writes before the host can cut power
+    eeprom_driver_flush();
+#endif
+
 #ifndef NO_SUSPEND_POWER_DOWN
 // Turn off backlight
 #    ifdef BACKLIGHT_ENABLE
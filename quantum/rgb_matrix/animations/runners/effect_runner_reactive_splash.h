@@ -4,10 +4,59 @@
 
 typedef HSV (*reactive_splash_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
+#    ifdef RGB_MATRIX_REACTIVE_DISTANCE_CACHE
+// Distances from every LED to the LED of a recent hit, one row per hit LED.
+// A row is filled when its LED is first hit, rather than computing the distances on every frame.
+static uint8_t reactive_distance_led[LED_HITS_TO_REMEMBER];
+static uint8_t reactive_distance[LED_HITS_TO_REMEMBER][DRIVER_LED_TOTAL];
+static uint8_t reactive_distance_rows = 0;
+
+static const uint8_t* reactive_distance_row(uint8_t hit_led) {
+    uint8_t row;
+    for (row = 0; row < reactive_distance_rows; row++) {
+        if (reactive_distance_led[row] == hit_led) {
+            return reactive_distance[row];
+        }
+    }
+
+    if (reactive_distance_rows < LED_HITS_TO_REMEMBER) {
+        row = reactive_distance_rows++;
+    } else {
+        // Replace a row that no remembered hit refers to. As there are as many rows as hits, and this hit has no row yet, one is always free.
+        for (row = 0; row < LED_HITS_TO_REMEMBER - 1; row++) {
+            bool in_use = false;
+            for (uint8_t j = 0; j < g_last_hit_tracker.count; j++) {
+                if (g_last_hit_tracker.index[j] == reactive_distance_led[row]) {
+                    in_use = true;
+                    break;
+                }
+            }
+            if (!in_use) {
+                break;
+            }
+        }
+    }
+
+    reactive_distance_led[row] = hit_led;
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        int16_t dx                = g_led_config.point[i].x - g_led_config.point[hit_led].x;
+        int16_t dy                = g_led_config.point[i].y - g_led_config.point[hit_led].y;
+        reactive_distance[row][i] = sqrt16(dx * dx + dy * dy);
+    }
+    return reactive_distance[row];
+}
+#    endif
+
 bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
     uint8_t count = g_last_hit_tracker.count;
+#    ifdef RGB_MATRIX_REACTIVE_DISTANCE_CACHE
+    const uint8_t* distances[LED_HITS_TO_REMEMBER];
+    for (uint8_t j = start; j < count; j++) {
+        distances[j] = reactive_distance_row(g_last_hit_tracker.index[j]);
+    }
+#    endif
     for (uint8_t i = led_min; i < led_max; i++) {
         RGB_MATRIX_TEST_LED_FLAGS();
         HSV hsv = rgb_matrix_config.hsv;
@@ -15,7 +64,11 @@ bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, react
         for (uint8_t j = start; j < count; j++) {
             int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
             int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
+#    ifdef RGB_MATRIX_REACTIVE_DISTANCE_CACHE
+            uint8_t  dist = distances[j][i];
+#    else
             uint8_t  dist = sqrt16(dx * dx + dy * dy);
+#    endif
             uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], qadd8(rgb_matrix_config.speed, 1));
             hsv           = effect_func(hsv, dx, dy, dist, tick);
         }
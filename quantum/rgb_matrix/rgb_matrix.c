@@ -108,6 +108,16 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv
 #    define RGB_MATRIX_STARTUP_SPD UINT8_MAX / 2
 #endif
 
+#ifdef RGB_MATRIX_ASYNC_FLUSH
+#    ifndef PROTOCOL_CHIBIOS
+#        error "RGB_MATRIX_ASYNC_FLUSH is only supported on ChibiOS"
+#    endif
+#    include <ch.h>
+#    ifndef RGB_MATRIX_ASYNC_FLUSH_STACK_SIZE
+#        define RGB_MATRIX_ASYNC_FLUSH_STACK_SIZE 256
+#    endif
+#endif
+
 // globals
 rgb_config_t rgb_matrix_config;  // TODO: would like to prefix this with g_ for global consistancy, do this in another pr
 uint32_t     g_rgb_timer;
@@ -127,6 +137,14 @@ static rgb_task_states rgb_task_state    = SYNCING;
 #if RGB_DISABLE_TIMEOUT > 0
 static uint32_t rgb_anykey_timer;
 #endif  // RGB_DISABLE_TIMEOUT > 0
+#ifdef RGB_MATRIX_ASYNC_FLUSH
+// Effects render into the back buffer, the flush thread sends the front buffer to the driver
+static RGB                rgb_back_buffer[DRIVER_LED_TOTAL];
+static RGB                rgb_front_buffer[DRIVER_LED_TOTAL];
+static volatile bool      rgb_flush_busy = false;
+static binary_semaphore_t rgb_flush_sem;
+static THD_WORKING_AREA(waRgbFlushThread, RGB_MATRIX_ASYNC_FLUSH_STACK_SIZE);
+#endif  // RGB_MATRIX_ASYNC_FLUSH
 
 // double buffers
 static uint32_t rgb_timer_buffer;
@@ -176,17 +194,63 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
+#ifdef RGB_MATRIX_ASYNC_FLUSH
+static THD_FUNCTION(RgbFlushThread, arg) {
+    (void)arg;
+    chRegSetThreadName("rgb_flush");
+
+    while (true) {
+        chBSemWait(&rgb_flush_sem);
+
+        for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+            rgb_matrix_driver.set_color(i, rgb_front_buffer[i].r, rgb_front_buffer[i].g, rgb_front_buffer[i].b);
+        }
+        rgb_matrix_driver.flush();
+
+        rgb_flush_busy = false;
+    }
+}
+
+static void rgb_flush_init(void) {
+    chBSemObjectInit(&rgb_flush_sem, true);
+    chThdCreateStatic(waRgbFlushThread, sizeof(waRgbFlushThread), NORMALPRIO + 1, RgbFlushThread, NULL);
+}
+
+static void rgb_flush_wait(void) {
+    while (rgb_flush_busy) {
+        chThdSleep(1);
+    }
+}
+
+void rgb_matrix_update_pwm_buffers(void) {
+    rgb_flush_wait();
+    memcpy(rgb_front_buffer, rgb_back_buffer, sizeof(rgb_front_buffer));
+    rgb_flush_busy = true;
+    chBSemSignal(&rgb_flush_sem);
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index >= 0 && index < DRIVER_LED_TOTAL) {
+        rgb_back_buffer[index] = (RGB){.r = red, .g = green, .b = blue};
+    }
+}
+
+void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) rgb_matrix_set_color(i, red, green, blue);
+}
+#else
 void rgb_matrix_update_pwm_buffers(void) { rgb_matrix_driver.flush(); }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color(index, red, green, blue); }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
-#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+#    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
     for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) rgb_matrix_set_color(i, red, green, blue);
-#else
+#    else
     rgb_matrix_driver.set_color_all(red, green, blue);
-#endif
+#    endif
 }
+#endif  // RGB_MATRIX_ASYNC_FLUSH
 
 void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #ifndef RGB_MATRIX_SPLIT
@@ -304,6 +368,15 @@ static void rgb_task_sync(void) {
 }
 
 static void rgb_task_start(void) {
+#ifdef RGB_MATRIX_ASYNC_FLUSH
+    // wait for the previous frame to reach the driver before rendering the next one
+    if (rgb_flush_busy) return;
+#endif  // RGB_MATRIX_ASYNC_FLUSH
+#if defined(WS2812)
+    // skip the frame while the driver is still sending the previous one, rather than waiting for it
+    if (ws2812_is_busy()) return;
+#endif
+
     // reset iter
     rgb_effect_params.iter = 0;
 
@@ -455,6 +528,9 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min,
 
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
+#ifdef RGB_MATRIX_ASYNC_FLUSH
+    rgb_flush_init();
+#endif  // RGB_MATRIX_ASYNC_FLUSH
 
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
@@ -487,6 +563,9 @@ void rgb_matrix_set_suspend_state(bool state) {
     if (state && !suspend_state) {  // only run if turning off, and only once
         rgb_task_render(0);         // turn off all LEDs when suspending
         rgb_task_flush(0);          // and actually flash led state to LEDs
+#    ifdef RGB_MATRIX_ASYNC_FLUSH
+        rgb_flush_wait();
+#    endif
     }
     suspend_state = state;
 #endif
@@ -0,0 +1,413 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "scan_profile.h"
+#include "timer.h"
+#include "debug.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <hal.h>
+#endif
+
+#if defined(__AVR__)
+#    include <avr/io.h>
+#    include <util/atomic.h>
+#    include "timer_avr.h"
+#endif
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#    define SCAN_PROFILE_USE_DWT
+#    define SCAN_PROFILE_TICK_UNIT "cycles"
+#elif defined(__AVR__)
+#    define SCAN_PROFILE_USE_TIMER0
+#    define SCAN_PROFILE_TICK_UNIT "timer0 ticks"
+// Set when timer0 has reached its top value, but the interrupt counting milliseconds hasn't run yet
+#    if defined(__AVR_ATmega32A__)
+#        define SCAN_PROFILE_TIMER0_PENDING (TIFR & _BV(OCF0))
+#    elif defined(__AVR_ATtiny85__)
+#        define SCAN_PROFILE_TIMER0_PENDING (TIFR & _BV(OCF0A))
+#    else
+#        define SCAN_PROFILE_TIMER0_PENDING (TIFR0 & _BV(OCF0A))
+#    endif
+#else
+#    define SCAN_PROFILE_TICK_UNIT "ms"
+#endif
+
+#ifndef SCAN_PROFILE_BUCKETS
+#    define SCAN_PROFILE_BUCKETS 20
+#endif
+
+#ifndef SCAN_PROFILE_REPORT_INTERVAL
+#    define SCAN_PROFILE_REPORT_INTERVAL 10000
+#endif
+
+#ifndef SCAN_PROFILE_RAW_HID_COMMAND
+#    define SCAN_PROFILE_RAW_HID_COMMAND 0xFE
+#endif
+
+// Requests which can be sent in the second byte of a raw HID packet
+enum {
+    SCAN_PROFILE_RAW_HID_GET_STAGE   = 0x00,
+    SCAN_PROFILE_RAW_HID_GET_HANDLER = 0x01,
+    SCAN_PROFILE_RAW_HID_RESET       = 0x02,
+    SCAN_PROFILE_RAW_HID_UNHANDLED   = 0xFF,
+};
+
+// Bucket 0 holds zero-length samples, bucket n holds samples of [2^(n-1), 2^n) ticks.
+// The last bucket also holds everything longer.
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint16_t buckets[SCAN_PROFILE_BUCKETS];
+} scan_profile_histogram_t;
+
+static scan_profile_histogram_t histograms[SCAN_PROFILE_NUM_STAGES];
+static process_profile_stats_t  handler_stats[PROCESS_PROFILE_NUM_HANDLERS];
+
+#if defined(CONSOLE_ENABLE)
+static const char *const stage_names[SCAN_PROFILE_NUM_STAGES] = {
+    [SCAN_PROFILE_KEYBOARD_TASK] = "keyboard_task",
+    [SCAN_PROFILE_MATRIX_SCAN]   = "matrix_scan",
+    [SCAN_PROFILE_DEBOUNCE]      = "debounce",
+    [SCAN_PROFILE_ACTION_EXEC]   = "action_exec",
+#    ifdef RGBLIGHT_ENABLE
+    [SCAN_PROFILE_RGBLIGHT_TASK] = "rgblight_task",
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+    [SCAN_PROFILE_LED_MATRIX_TASK] = "led_matrix_task",
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    [SCAN_PROFILE_RGB_MATRIX_TASK] = "rgb_matrix_task",
+#    endif
+#    ifdef BACKLIGHT_ENABLE
+    [SCAN_PROFILE_BACKLIGHT_TASK] = "backlight_task",
+#    endif
+#    ifdef ENCODER_ENABLE
+    [SCAN_PROFILE_ENCODER_READ] = "encoder_read",
+#    endif
+#    ifdef OLED_ENABLE
+    [SCAN_PROFILE_OLED_TASK] = "oled_task",
+#    endif
+#    ifdef ST7565_ENABLE
+    [SCAN_PROFILE_ST7565_TASK] = "st7565_task",
+#    endif
+#    ifdef MOUSEKEY_ENABLE
+    [SCAN_PROFILE_MOUSEKEY_TASK] = "mousekey_task",
+#    endif
+#    ifdef PS2_MOUSE_ENABLE
+    [SCAN_PROFILE_PS2_MOUSE_TASK] = "ps2_mouse_task",
+#    endif
+#    ifdef POINTING_DEVICE_ENABLE
+    [SCAN_PROFILE_POINTING_DEVICE_TASK] = "pointing_device_task",
+#    endif
+#    ifdef MIDI_ENABLE
+    [SCAN_PROFILE_MIDI_TASK] = "midi_task",
+#    endif
+#    ifdef JOYSTICK_ENABLE
+    [SCAN_PROFILE_JOYSTICK_TASK] = "joystick_task",
+#    endif
+#    ifdef DIGITIZER_ENABLE
+    [SCAN_PROFILE_DIGITIZER_TASK] = "digitizer_task",
+#    endif
+#    ifdef PROGRAMMABLE_BUTTON_ENABLE
+    [SCAN_PROFILE_PROGRAMMABLE_BUTTON_SEND] = "programmable_button_send",
+#    endif
+};
+
+static const char *const handler_names[PROCESS_PROFILE_NUM_HANDLERS] = {
+#    ifdef COMBO_ENABLE
+    [PROCESS_PROFILE_COMBO] = "combo",
+#    endif
+#    if defined(KEY_LOCK_ENABLE)
+    [PROCESS_PROFILE_KEY_LOCK] = "key_lock",
+#    endif
+#    if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
+    [PROCESS_PROFILE_DYNAMIC_MACRO] = "dynamic_macro",
+#    endif
+#    if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
+    [PROCESS_PROFILE_CLICKY] = "clicky",
+#    endif
+#    ifdef HAPTIC_ENABLE
+    [PROCESS_PROFILE_HAPTIC] = "haptic",
+#    endif
+#    if defined(VIA_ENABLE)
+    [PROCESS_PROFILE_VIA] = "via",
+#    endif
+    [PROCESS_PROFILE_RECORD_KB] = "record_kb",
+#    if defined(SEQUENCER_ENABLE)
+    [PROCESS_PROFILE_SEQUENCER] = "sequencer",
+#    endif
+#    if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
+    [PROCESS_PROFILE_MIDI] = "midi",
+#    endif
+#    ifdef AUDIO_ENABLE
+    [PROCESS_PROFILE_AUDIO] = "audio",
+#    endif
+#    if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
+    [PROCESS_PROFILE_BACKLIGHT] = "backlight",
+#    endif
+#    ifdef STENO_ENABLE
+    [PROCESS_PROFILE_STENO] = "steno",
+#    endif
+#    if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
+    [PROCESS_PROFILE_MUSIC] = "music",
+#    endif
+#    ifdef KEY_OVERRIDE_ENABLE
+    [PROCESS_PROFILE_KEY_OVERRIDE] = "key_override",
+#    endif
+#    ifdef TAP_DANCE_ENABLE
+    [PROCESS_PROFILE_TAP_DANCE] = "tap_dance",
+#    endif
+#    if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
+    [PROCESS_PROFILE_UNICODE_COMMON] = "unicode_common",
+#    endif
+#    ifdef LEADER_ENABLE
+    [PROCESS_PROFILE_LEADER] = "leader",
+#    endif
+#    ifdef PRINTING_ENABLE
+    [PROCESS_PROFILE_PRINTER] = "printer",
+#    endif
+#    ifdef AUTO_SHIFT_ENABLE
+    [PROCESS_PROFILE_AUTO_SHIFT] = "auto_shift",
+#    endif
+#    ifdef DYNAMIC_TAPPING_TERM_ENABLE
+    [PROCESS_PROFILE_DYNAMIC_TAPPING_TERM] = "dynamic_tapping_term",
+#    endif
+#    ifdef TERMINAL_ENABLE
+    [PROCESS_PROFILE_TERMINAL] = "terminal",
+#    endif
+#    ifdef SPACE_CADET_ENABLE
+    [PROCESS_PROFILE_SPACE_CADET] = "space_cadet",
+#    endif
+#    ifdef MAGIC_KEYCODE_ENABLE
+    [PROCESS_PROFILE_MAGIC] = "magic",
+#    endif
+#    ifdef GRAVE_ESC_ENABLE
+    [PROCESS_PROFILE_GRAVE_ESC] = "grave_esc",
+#    endif
+#    if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
+    [PROCESS_PROFILE_RGB] = "rgb",
+#    endif
+#    ifdef JOYSTICK_ENABLE
+    [PROCESS_PROFILE_JOYSTICK] = "joystick",
+#    endif
+#    ifdef PROGRAMMABLE_BUTTON_ENABLE
+    [PROCESS_PROFILE_PROGRAMMABLE_BUTTON] = "programmable_button",
+#    endif
+};
+#endif
+
+uint32_t scan_profile_ticks(void) {
+#ifdef SCAN_PROFILE_USE_DWT
+    static bool dwt_enabled = false;
+    if (!dwt_enabled) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        dwt_enabled = true;
+    }
+    return DWT->CYCCNT;
+#elif defined(SCAN_PROFILE_USE_TIMER0)
+    // The millisecond timer counts timer0 from 0 to TIMER_RAW_TOP every millisecond, so
+    // combining both gives a resolution of TIMER_PRESCALER cycles (4us at 16MHz).
+    uint32_t ms;
+    uint8_t  raw;
+    bool     pending;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms      = timer_count;
+        raw     = TIMER_RAW;
+        pending = SCAN_PROFILE_TIMER0_PENDING;
+    }
+    // timer0 wrapped before it was read, but that millisecond hasn't been counted yet
+    if (pending && raw < TIMER_RAW_TOP / 2) {
+        ms++;
+    }
+    return ms * (TIMER_RAW_TOP + 1) + raw;
+#else
+    return timer_read32();
+#endif
+}
+
+static uint8_t bucket_for(uint32_t ticks) {
+    uint8_t bucket = 0;
+    while (ticks && bucket < SCAN_PROFILE_BUCKETS - 1) {
+        ticks >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void scan_profile_record(scan_profile_stage_t stage, uint32_t ticks) {
+    if (stage >= SCAN_PROFILE_NUM_STAGES) {
+        return;
+    }
+
+    scan_profile_histogram_t *histogram = &histograms[stage];
+    uint8_t                   bucket    = bucket_for(ticks);
+
+    if (histogram->count == 0 || ticks < histogram->min) {
+        histogram->min = ticks;
+    }
+    if (ticks > histogram->max) {
+        histogram->max = ticks;
+    }
+    if (histogram->count < UINT32_MAX) {
+        histogram->count++;
+    }
+
+    // Halve the whole histogram rather than saturate, so the distribution is preserved
+    if (histogram->buckets[bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < SCAN_PROFILE_BUCKETS; i++) {
+            histogram->buckets[i] >>= 1;
+        }
+    }
+    histogram->buckets[bucket]++;
+}
+
+void process_profile_record(process_profile_handler_t handler, uint32_t ticks, bool result) {
+    if (handler >= PROCESS_PROFILE_NUM_HANDLERS) {
+        return;
+    }
+
+    process_profile_stats_t *stats = &handler_stats[handler];
+
+    // Stop accumulating rather than wrap, so the counters stay consistent with each other
+    if (stats->count == UINT32_MAX || stats->total > UINT32_MAX - ticks) {
+        return;
+    }
+
+    stats->count++;
+    stats->total += ticks;
+    if (!result) {
+        stats->stopped++;
+    }
+    if (ticks > stats->max) {
+        stats->max = ticks;
+    }
+}
+
+void process_profile_get(process_profile_handler_t handler, process_profile_stats_t *stats) {
+    if (handler >= PROCESS_PROFILE_NUM_HANDLERS) {
+        *stats = (process_profile_stats_t){0};
+        return;
+    }
+    *stats = handler_stats[handler];
+}
+
+void scan_profile_get(scan_profile_stage_t stage, scan_profile_stats_t *stats) {
+    *stats = (scan_profile_stats_t){0};
+    if (stage >= SCAN_PROFILE_NUM_STAGES || histograms[stage].count == 0) {
+        return;
+    }
+
+    const scan_profile_histogram_t *histogram = &histograms[stage];
+
+    stats->count = histogram->count;
+    stats->min   = histogram->min;
+    stats->max   = histogram->max;
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < SCAN_PROFILE_BUCKETS; i++) {
+        total += histogram->buckets[i];
+    }
+
+    // Rank of the 99th percentile sample, rounded up
+    uint32_t rank       = (total * 99 + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < SCAN_PROFILE_BUCKETS; i++) {
+        cumulative += histogram->buckets[i];
+        if (cumulative >= rank) {
+            uint32_t upper = (i == 0) ? 0 : ((i == SCAN_PROFILE_BUCKETS - 1) ? UINT32_MAX : (((uint32_t)1 << i) - 1));
+            stats->p99     = upper < histogram->max ? upper : histogram->max;
+            if (stats->p99 < histogram->min) {
+                stats->p99 = histogram->min;
+            }
+            break;
+        }
+    }
+}
+
+void scan_profile_reset(void) {
+    for (uint8_t i = 0; i < SCAN_PROFILE_NUM_STAGES; i++) {
+        histograms[i] = (scan_profile_histogram_t){0};
+    }
+    for (uint8_t i = 0; i < PROCESS_PROFILE_NUM_HANDLERS; i++) {
+        handler_stats[i] = (process_profile_stats_t){0};
+    }
+}
+
+// Big endian, like the other raw HID protocols
+static void scan_profile_put_u32(uint8_t *data, uint32_t value) {
+    data[0] = (value >> 24) & 0xFF;
+    data[1] = (value >> 16) & 0xFF;
+    data[2] = (value >> 8) & 0xFF;
+    data[3] = value & 0xFF;
+}
+
+bool scan_profile_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 20 || data[0] != SCAN_PROFILE_RAW_HID_COMMAND) {
+        return false;
+    }
+
+    switch (data[1]) {
+        case SCAN_PROFILE_RAW_HID_GET_STAGE: {
+            scan_profile_stats_t stats;
+            scan_profile_get(data[2], &stats);
+            data[3] = SCAN_PROFILE_NUM_STAGES;
+            scan_profile_put_u32(&data[4], stats.count);
+            scan_profile_put_u32(&data[8], stats.min);
+            scan_profile_put_u32(&data[12], stats.p99);
+            scan_profile_put_u32(&data[16], stats.max);
+            break;
+        }
+        case SCAN_PROFILE_RAW_HID_GET_HANDLER: {
+            process_profile_stats_t stats;
+            process_profile_get(data[2], &stats);
+            data[3] = PROCESS_PROFILE_NUM_HANDLERS;
+            scan_profile_put_u32(&data[4], stats.count);
+            scan_profile_put_u32(&data[8], stats.stopped);
+            scan_profile_put_u32(&data[12], stats.total);
+            scan_profile_put_u32(&data[16], stats.max);
+            break;
+        }
+        case SCAN_PROFILE_RAW_HID_RESET:
+            scan_profile_reset();
+            break;
+        default:
+            data[1] = SCAN_PROFILE_RAW_HID_UNHANDLED;
+            break;
+    }
+    return true;
+}
+
+void scan_profile_print(void) {
+#if defined(CONSOLE_ENABLE)
+    scan_profile_stats_t stats;
+    dprintf("scan profile (" SCAN_PROFILE_TICK_UNIT "): stage count min p99 max\n");
+    for (uint8_t i = 0; i < SCAN_PROFILE_NUM_STAGES; i++) {
+        scan_profile_get(i, &stats);
+        dprintf("  %s %lu %lu %lu %lu\n", stage_names[i], stats.count, stats.min, stats.p99, stats.max);
+    }
+
+    process_profile_stats_t handler;
+    dprintf("process_record (" SCAN_PROFILE_TICK_UNIT "): handler count stopped total max\n");
+    for (uint8_t i = 0; i < PROCESS_PROFILE_NUM_HANDLERS; i++) {
+        process_profile_get(i, &handler);
+        if (handler.count) {
+            dprintf("  %s %lu %lu %lu %lu\n", handler_names[i], handler.count, handler.stopped, handler.total, handler.max);
+        }
+    }
+#endif
+}
+
+void scan_profile_task(void) {
+#if defined(CONSOLE_ENABLE) && SCAN_PROFILE_REPORT_INTERVAL > 0
+    static uint32_t last_report = 0;
+    if (timer_elapsed32(last_report) > SCAN_PROFILE_REPORT_INTERVAL) {
+        scan_profile_print();
+        scan_profile_reset();
+        last_report = timer_read32();
+    }
+#endif
+}
@@ -0,0 +1,224 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stages of keyboard_task() which are timed when SCAN_PROFILE_ENABLE is set.
+// Stages may nest, e.g. SCAN_PROFILE_DEBOUNCE is also accounted for in SCAN_PROFILE_MATRIX_SCAN.
+typedef enum {
+    SCAN_PROFILE_KEYBOARD_TASK,
+    SCAN_PROFILE_MATRIX_SCAN,
+    SCAN_PROFILE_DEBOUNCE,
+    SCAN_PROFILE_ACTION_EXEC,
+#ifdef RGBLIGHT_ENABLE
+    SCAN_PROFILE_RGBLIGHT_TASK,
+#endif
+#ifdef LED_MATRIX_ENABLE
+    SCAN_PROFILE_LED_MATRIX_TASK,
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    SCAN_PROFILE_RGB_MATRIX_TASK,
+#endif
+#ifdef BACKLIGHT_ENABLE
+    SCAN_PROFILE_BACKLIGHT_TASK,
+#endif
+#ifdef ENCODER_ENABLE
+    SCAN_PROFILE_ENCODER_READ,
+#endif
+#ifdef OLED_ENABLE
+    SCAN_PROFILE_OLED_TASK,
+#endif
+#ifdef ST7565_ENABLE
+    SCAN_PROFILE_ST7565_TASK,
+#endif
+#ifdef MOUSEKEY_ENABLE
+    SCAN_PROFILE_MOUSEKEY_TASK,
+#endif
+#ifdef PS2_MOUSE_ENABLE
+    SCAN_PROFILE_PS2_MOUSE_TASK,
+#endif
+#ifdef POINTING_DEVICE_ENABLE
+    SCAN_PROFILE_POINTING_DEVICE_TASK,
+#endif
+#ifdef MIDI_ENABLE
+    SCAN_PROFILE_MIDI_TASK,
+#endif
+#ifdef JOYSTICK_ENABLE
+    SCAN_PROFILE_JOYSTICK_TASK,
+#endif
+#ifdef DIGITIZER_ENABLE
+    SCAN_PROFILE_DIGITIZER_TASK,
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+    SCAN_PROFILE_PROGRAMMABLE_BUTTON_SEND,
+#endif
+    SCAN_PROFILE_NUM_STAGES
+} scan_profile_stage_t;
+
+// Key event handlers called from process_record_quantum() which are timed when SCAN_PROFILE_ENABLE is set.
+// Their cost is also accounted for in SCAN_PROFILE_ACTION_EXEC.
+typedef enum {
+#ifdef COMBO_ENABLE
+    PROCESS_PROFILE_COMBO,
+#endif
+#if defined(KEY_LOCK_ENABLE)
+    PROCESS_PROFILE_KEY_LOCK,
+#endif
+#if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
+    PROCESS_PROFILE_DYNAMIC_MACRO,
+#endif
+#if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
+    PROCESS_PROFILE_CLICKY,
+#endif
+#ifdef HAPTIC_ENABLE
+    PROCESS_PROFILE_HAPTIC,
+#endif
+#if defined(VIA_ENABLE)
+    PROCESS_PROFILE_VIA,
+#endif
+    PROCESS_PROFILE_RECORD_KB,
+#if defined(SEQUENCER_ENABLE)
+    PROCESS_PROFILE_SEQUENCER,
+#endif
+#if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
+    PROCESS_PROFILE_MIDI,
+#endif
+#ifdef AUDIO_ENABLE
+    PROCESS_PROFILE_AUDIO,
+#endif
+#if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
+    PROCESS_PROFILE_BACKLIGHT,
+#endif
+#ifdef STENO_ENABLE
+    PROCESS_PROFILE_STENO,
+#endif
+#if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
+    PROCESS_PROFILE_MUSIC,
+#endif
+#ifdef KEY_OVERRIDE_ENABLE
+    PROCESS_PROFILE_KEY_OVERRIDE,
+#endif
+#ifdef TAP_DANCE_ENABLE
+    PROCESS_PROFILE_TAP_DANCE,
+#endif
+#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
+    PROCESS_PROFILE_UNICODE_COMMON,
+#endif
+#ifdef LEADER_ENABLE
+    PROCESS_PROFILE_LEADER,
+#endif
+#ifdef PRINTING_ENABLE
+    PROCESS_PROFILE_PRINTER,
+#endif
+#ifdef AUTO_SHIFT_ENABLE
+    PROCESS_PROFILE_AUTO_SHIFT,
+#endif
+#ifdef DYNAMIC_TAPPING_TERM_ENABLE
+    PROCESS_PROFILE_DYNAMIC_TAPPING_TERM,
+#endif
+#ifdef TERMINAL_ENABLE
+    PROCESS_PROFILE_TERMINAL,
+#endif
+#ifdef SPACE_CADET_ENABLE
+    PROCESS_PROFILE_SPACE_CADET,
+#endif
+#ifdef MAGIC_KEYCODE_ENABLE
+    PROCESS_PROFILE_MAGIC,
+#endif
+#ifdef GRAVE_ESC_ENABLE
+    PROCESS_PROFILE_GRAVE_ESC,
+#endif
+#if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
+    PROCESS_PROFILE_RGB,
+#endif
+#ifdef JOYSTICK_ENABLE
+    PROCESS_PROFILE_JOYSTICK,
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+    PROCESS_PROFILE_PROGRAMMABLE_BUTTON,
+#endif
+    PROCESS_PROFILE_NUM_HANDLERS
+} process_profile_handler_t;
+
+typedef struct {
+    uint32_t count;  // number of samples since the last reset
+    uint32_t min;    // shortest sample, in ticks
+    uint32_t max;    // longest sample, in ticks
+    uint32_t p99;    // upper bound of the histogram bucket holding the 99th percentile, in ticks
+} scan_profile_stats_t;
+
+typedef struct {
+    uint32_t count;    // number of key events the handler was called for since the last reset
+    uint32_t stopped;  // number of those events for which the handler returned false
+    uint32_t total;    // accumulated time spent in the handler, in ticks
+    uint32_t max;      // longest single call, in ticks
+} process_profile_stats_t;
+
+// Returns the current value of the profiling timebase.
+// This is the DWT cycle counter on Cortex-M3 and above, timer0 (TIMER_PRESCALER cycles per tick) on AVR,
+// and the millisecond timer elsewhere.
+uint32_t scan_profile_ticks(void);
+
+// Adds one sample of the given duration (in ticks) to a stage's histogram.
+void scan_profile_record(scan_profile_stage_t stage, uint32_t ticks);
+
+// Retrieves the statistics gathered for a stage since the last reset.
+void scan_profile_get(scan_profile_stage_t stage, scan_profile_stats_t *stats);
+
+// Adds one call of the given duration (in ticks) and result to a key event handler's counters.
+void process_profile_record(process_profile_handler_t handler, uint32_t ticks, bool result);
+
+// Retrieves the counters gathered for a key event handler since the last reset.
+void process_profile_get(process_profile_handler_t handler, process_profile_stats_t *stats);
+
+// Clears all gathered statistics, including the key event handler counters.
+void scan_profile_reset(void);
+
+// Prints the statistics of every stage and key event handler to the console.
+void scan_profile_print(void);
+
+// Answers a statistics request received over raw HID, see docs/faq_debug.md for the packet layout.
+// The reply is written into data, which the caller sends back with raw_hid_send().
+// Returns false, leaving data untouched, if the packet is not a scan profile request.
+bool scan_profile_raw_hid_receive(uint8_t *data, uint8_t length);
+
+// Forward declaration for keyboard_task() in order to periodically report statistics. Should not be invoked by keyboard/user code.
+void scan_profile_task(void);
+
+#ifdef SCAN_PROFILE_ENABLE
+#    define SCAN_PROFILE(stage, ...)                                                \
+        do {                                                                        \
+            uint32_t scan_profile_start = scan_profile_ticks();                     \
+            __VA_ARGS__;                                                            \
+            scan_profile_record(stage, scan_profile_ticks() - scan_profile_start); \
+        } while (0)
+#else
+#    define SCAN_PROFILE(stage, ...) \
+        do {                         \
+            __VA_ARGS__;             \
+        } while (0)
+#endif
+
+// Evaluates a key event handler call, timing it when SCAN_PROFILE_ENABLE is set, and yields its result.
+#ifdef SCAN_PROFILE_ENABLE
+#    define PROCESS_PROFILE(handler, ...)                                                                          \
+        ({                                                                                                         \
+            uint32_t process_profile_start  = scan_profile_ticks();                                                \
+            bool     process_profile_result = (__VA_ARGS__);                                                       \
+            process_profile_record(handler, scan_profile_ticks() - process_profile_start, process_profile_result); \
+            process_profile_result;                                                                                \
+        })
+#else
+#    define PROCESS_PROFILE(handler, ...) (__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -142,6 +142,94 @@ __attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
 // Note: we bit-pack in "reverse" order to optimize loading
 #define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
 
+#ifdef SENDSTRING_BULK
+#    ifndef SENDSTRING_BULK_KEYS
+#        define SENDSTRING_BULK_KEYS KEYBOARD_REPORT_KEYS
+#    endif
+
+// Keys pressed together in the next report, in ascending order so that hosts
+// walking the report in usage (or array) order see them in string order
+static uint8_t bulk_keys[SENDSTRING_BULK_KEYS];
+static uint8_t bulk_count = 0;
+static uint8_t bulk_mods  = 0;
+
+__attribute__((weak)) void send_string_wait_for_host(void) {}
+
+static bool bulk_has_room(void) {
+    if (bulk_count == SENDSTRING_BULK_KEYS) {
+        return false;
+    }
+#    ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        return true;
+    }
+#    endif
+    return has_anykey(keyboard_report) < KEYBOARD_REPORT_KEYS;
+}
+
+static void bulk_send_keys(void) {
+    if (bulk_count == 0) {
+        return;
+    }
+
+    send_string_wait_for_host();
+    send_keyboard_report();
+    for (uint16_t i = TAP_CODE_DELAY; i > 0; i--) {
+        wait_ms(1);
+    }
+    for (uint8_t i = 0; i < bulk_count; i++) {
+        del_key(bulk_keys[i]);
+    }
+    send_string_wait_for_host();
+    send_keyboard_report();
+    bulk_count = 0;
+}
+
+static void bulk_set_mods(uint8_t mods) {
+    if (mods == bulk_mods) {
+        return;
+    }
+
+    bulk_send_keys();
+    del_mods(bulk_mods & ~mods);
+    add_mods(mods & ~bulk_mods);
+    send_string_wait_for_host();
+    send_keyboard_report();
+    bulk_mods = mods;
+}
+
+static void bulk_flush(void) {
+    bulk_send_keys();
+    bulk_set_mods(0);
+}
+
+// Returns false, after flushing, for characters that have to go through send_char()
+static bool bulk_send_char(char ascii_code) {
+    uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+
+    if (!IS_KEY(keycode) || PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code)) {
+        bulk_flush();
+        return false;
+    }
+
+    uint8_t mods = 0;
+    if (PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code)) {
+        mods |= MOD_BIT(KC_LSFT);
+    }
+    if (PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code)) {
+        mods |= MOD_BIT(KC_RALT);
+    }
+    bulk_set_mods(mods);
+
+    if (bulk_count > 0 && (keycode <= bulk_keys[bulk_count - 1] || !bulk_has_room())) {
+        bulk_send_keys();
+    }
+    add_key(keycode);
+    bulk_keys[bulk_count++] = keycode;
+    return true;
+}
+#endif
+
 void send_string(const char *str) { send_string_with_delay(str, 0); }
 
 void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
@@ -151,6 +239,9 @@ void send_string_with_delay(const char *str, uint8_t interval) {
         char ascii_code = *str;
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+#ifdef SENDSTRING_BULK
+            bulk_flush();
+#endif
             ascii_code = *(++str);
             if (ascii_code == SS_TAP_CODE) {
                 // tap
@@ -176,6 +267,12 @@ void send_string_with_delay(const char *str, uint8_t interval) {
                 while (ms--) wait_ms(1);
             }
         } else {
+#ifdef SENDSTRING_BULK
+            if (interval == 0 && bulk_send_char(ascii_code)) {
+                ++str;
+                continue;
+            }
+#endif
             send_char(ascii_code);
         }
         ++str;
@@ -185,6 +282,9 @@ void send_string_with_delay(const char *str, uint8_t interval) {
             while (ms--) wait_ms(1);
         }
     }
+#ifdef SENDSTRING_BULK
+    bulk_flush();
+#endif
 }
 
 void send_string_with_delay_P(const char *str, uint8_t interval) {
@@ -192,6 +292,9 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
         char ascii_code = pgm_read_byte(str);
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
+#ifdef SENDSTRING_BULK
+            bulk_flush();
+#endif
             ascii_code = pgm_read_byte(++str);
             if (ascii_code == SS_TAP_CODE) {
                 // tap
@@ -217,6 +320,12 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
                 while (ms--) wait_ms(1);
             }
         } else {
+#ifdef SENDSTRING_BULK
+            if (interval == 0 && bulk_send_char(ascii_code)) {
+                ++str;
+                continue;
+            }
+#endif
             send_char(ascii_code);
         }
         ++str;
@@ -226,6 +335,9 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
             while (ms--) wait_ms(1);
         }
     }
+#ifdef SENDSTRING_BULK
+    bulk_flush();
+#endif
 }
 
 void send_char(char ascii_code) {
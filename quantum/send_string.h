@@ -46,6 +46,9 @@ void send_string_P(const char *str);
 void send_string_with_delay_P(const char *str, uint8_t interval);
 void send_char(char ascii_code);
 
+// With SENDSTRING_BULK, called before each keyboard report of a packed string
+void send_string_wait_for_host(void);
+
 void send_dword(uint32_t number);
 void send_word(uint16_t number);
 void send_byte(uint8_t number);
@@ -21,7 +21,11 @@ enum serial_transaction_id {
     I2C_EXECUTE_CALLBACK,
 #endif  // USE_I2C
 
+#ifdef SPLIT_TRANSPORT_DELTA
+    GET_SLAVE_MATRIX_DELTA,
+#else   // SPLIT_TRANSPORT_DELTA
     GET_SLAVE_MATRIX_CHECKSUM,
+#endif  // SPLIT_TRANSPORT_DELTA
     GET_SLAVE_MATRIX_DATA,
 
 #ifdef SPLIT_TRANSPORT_MIRROR
@@ -78,6 +82,11 @@ enum serial_transaction_id {
     PUT_ST7565,
 #endif  // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_TRANSPORT_BATCH
+    PUT_BATCH_INFO,
+    PUT_BATCH_DATA,
+#endif  // SPLIT_TRANSPORT_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
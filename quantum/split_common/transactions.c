@@ -42,7 +42,13 @@
     { &dummy, 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
-#define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
+#ifdef SPLIT_TRANSPORT_BATCH
+static bool batch_active = false;
+static bool transport_batch_write(int8_t id, const void *data, size_t length);
+#    define transport_write(id, data, length) (batch_active ? transport_batch_write(id, data, length) : transport_execute_transaction(id, data, length, NULL, 0))
+#else  // SPLIT_TRANSPORT_BATCH
+#    define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
+#endif  // SPLIT_TRANSPORT_BATCH
 #define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -111,9 +117,171 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
     return send_if_condition(trans_id, last_update, (memcmp(source, equiv_shmem, length) != 0), source, length);
 }
 
+////////////////////////////////////////////////////
+// Batched transfers
+
+#ifdef SPLIT_TRANSPORT_BATCH
+
+static uint32_t batch_pending = 0;
+
+static bool transport_batch_write(int8_t id, const void *data, size_t length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (trans->initiator2target_buffer_size >= sizeof(split_shmem->batch.buffer)) {
+        // Too large to share a frame, send it on its own
+        return transport_execute_transaction(id, data, length, NULL, 0);
+    }
+
+    // Stage the data in shared memory, it is picked up from there when the batch is sent
+    memcpy(split_trans_initiator2target_buffer(trans), data, length < trans->initiator2target_buffer_size ? length : trans->initiator2target_buffer_size);
+    batch_pending |= (uint32_t)1 << id;
+    return true;
+}
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    uint8_t buffer[sizeof(split_shmem->batch.buffer)];
+
+    while (batch_pending) {
+        // Pack as many pending transfers as fit, each as its transaction ID followed by its data
+        uint8_t  length = 0;
+        uint8_t  count  = 0;
+        uint32_t sent   = 0;
+        for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+            uint32_t                  mask  = (uint32_t)1 << id;
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            if (!(batch_pending & mask) || (size_t)length + 1 + trans->initiator2target_buffer_size > sizeof(buffer)) {
+                continue;
+            }
+            buffer[length++] = id;
+            memcpy(&buffer[length], split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+            length += trans->initiator2target_buffer_size;
+            sent |= mask;
+            count++;
+        }
+
+        if (count < 3) {
+            // Announcing the frame length takes a transaction of its own, so just a couple of transfers are cheaper to send directly
+            for (uint8_t offset = 0; offset < length;) {
+                int8_t  id   = buffer[offset++];
+                uint8_t size = split_transaction_table[id].initiator2target_buffer_size;
+                if (!transport_write(id, &buffer[offset], size)) {
+                    return false;
+                }
+                batch_pending &= ~((uint32_t)1 << id);
+                offset += size;
+            }
+        } else {
+            // Make sure the local side knows that we're not sending the full block of data
+            split_transaction_table[PUT_BATCH_DATA].initiator2target_buffer_size = length;
+            if (!transport_write(PUT_BATCH_INFO, &length, sizeof(length))) {
+                return false;
+            }
+            if (!transport_write(PUT_BATCH_DATA, buffer, length)) {
+                return false;
+            }
+            batch_pending &= ~sent;
+        }
+    }
+    return true;
+}
+
+static void slave_batch_info_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    // Size the data transaction to match the frame the master is about to send
+    uint8_t length                                                        = split_shmem->batch.length;
+    split_transaction_table[PUT_BATCH_DATA].initiator2target_buffer_size = length < sizeof(split_shmem->batch.buffer) ? length : sizeof(split_shmem->batch.buffer);
+}
+
+static void slave_batch_data_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    // Unpack each transfer into its usual shared memory location, as if it had been sent on its own
+    const uint8_t *buffer = split_shmem->batch.buffer;
+    uint8_t        length = split_transaction_table[PUT_BATCH_DATA].initiator2target_buffer_size;
+    for (uint8_t offset = 0; offset < length;) {
+        uint8_t id = buffer[offset++];
+        if (id >= PUT_BATCH_INFO) break;
+
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        if (!trans->status || trans->initiator2target_buffer_size > length - offset) break;
+
+        memcpy(split_trans_initiator2target_buffer(trans), &buffer[offset], trans->initiator2target_buffer_size);
+        if (trans->slave_callback) {
+            trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+        }
+        offset += trans->initiator2target_buffer_size;
+    }
+}
+
+// clang-format off
+#    define TRANSACTIONS_BATCH_MASTER() TRANSACTION_HANDLER_MASTER(batch)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+    [PUT_BATCH_INFO] = trans_initiator2target_initializer_cb(batch.length, slave_batch_info_callback), \
+    [PUT_BATCH_DATA] = trans_initiator2target_initializer_cb(batch.buffer, slave_batch_data_callback),
+// clang-format on
+
+#else  // SPLIT_TRANSPORT_BATCH
+
+#    define TRANSACTIONS_BATCH_MASTER()
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif  // SPLIT_TRANSPORT_BATCH
+
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#ifdef SPLIT_TRANSPORT_DELTA
+
+static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t            last_update                    = 0;
+    static matrix_row_t        last_matrix[(MATRIX_ROWS) / 2] = {0};  // last successfully-read matrix, so we can replicate if there are checksum errors
+    matrix_row_t               temp_matrix[(MATRIX_ROWS) / 2];        // holding area while we test whether or not checksum is correct
+    split_slave_matrix_delta_t delta;
+
+    bool okay = transport_read(GET_SLAVE_MATRIX_DELTA, &delta, sizeof(delta));
+    if (okay) {
+        // Apply the most recently changed row on top of the last known matrix
+        memcpy(temp_matrix, last_matrix, sizeof(temp_matrix));
+        if (delta.row < (MATRIX_ROWS) / 2) {
+            temp_matrix[delta.row] = delta.row_data;
+        }
+
+        // Fall back to reading the full matrix if the delta alone does not reproduce it
+        if (timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS || delta.checksum != crc8(temp_matrix, sizeof(temp_matrix))) {
+            okay &= transport_read(GET_SLAVE_MATRIX_DATA, temp_matrix, sizeof(temp_matrix));
+            okay &= delta.checksum == crc8(temp_matrix, sizeof(temp_matrix));
+            if (okay) {
+                last_update = timer_read32();
+            }
+        }
+    }
+    if (okay) {
+        // Checksum matches the received data, save as the last matrix state
+        memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
+    }
+    // Copy out the last-known-good matrix state to the slave matrix
+    memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
+    return okay;
+}
+
+static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    // Publish the first row that changed since the previous scan, leaving the last one in place otherwise.
+    // The row is sent as a whole, so the master can safely apply the same delta more than once.
+    for (uint8_t row = 0; row < (MATRIX_ROWS) / 2; row++) {
+        if (split_shmem->smatrix.matrix[row] != slave_matrix[row]) {
+            split_shmem->smatrix.delta.row      = row;
+            split_shmem->smatrix.delta.row_data = slave_matrix[row];
+            break;
+        }
+    }
+    memcpy(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix));
+    split_shmem->smatrix.delta.checksum = crc8(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+}
+
+// clang-format off
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+    [GET_SLAVE_MATRIX_DELTA] = trans_target2initiator_initializer(smatrix.delta), \
+    [GET_SLAVE_MATRIX_DATA]  = trans_target2initiator_initializer(smatrix.matrix),
+// clang-format on
+
+#else  // SPLIT_TRANSPORT_DELTA
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0};  // last successfully-read matrix, so we can replicate if there are checksum errors
@@ -135,13 +303,16 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
 }
 
 // clang-format off
-#define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
     [GET_SLAVE_MATRIX_CHECKSUM] = trans_target2initiator_initializer(smatrix.checksum), \
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+#endif  // SPLIT_TRANSPORT_DELTA
+
+#define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
+#define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -264,8 +435,12 @@ static bool layer_state_handlers_master(matrix_row_t master_matrix[], matrix_row
 }
 
 static void layer_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
-    layer_state         = split_shmem->layers.layer_state;
-    default_layer_state = split_shmem->layers.default_layer_state;
+    if (layer_state != split_shmem->layers.layer_state || default_layer_state != split_shmem->layers.default_layer_state) {
+        layer_state         = split_shmem->layers.layer_state;
+        default_layer_state = split_shmem->layers.default_layer_state;
+        // assigned directly so the slave doesn't run the layer callbacks, so the lookup cache has to be reset here
+        layer_lookup_cache_clear();
+    }
 }
 
 // clang-format off
@@ -604,6 +779,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_WPM_REGISTRATIONS
     TRANSACTIONS_OLED_REGISTRATIONS
     TRANSACTIONS_ST7565_REGISTRATIONS
+    TRANSACTIONS_BATCH_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -614,7 +790,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif  // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 };
 
-bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+static bool transactions_master_handlers(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -632,6 +808,19 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     return true;
 }
 
+bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#ifdef SPLIT_TRANSPORT_BATCH
+    // Queue up the master-to-slave transfers, and send them together once every handler has run
+    batch_active = true;
+    bool okay    = transactions_master_handlers(master_matrix, slave_matrix);
+    batch_active = false;
+    TRANSACTIONS_BATCH_MASTER();
+    return okay;
+#else   // SPLIT_TRANSPORT_BATCH
+    return transactions_master_handlers(master_matrix, slave_matrix);
+#endif  // SPLIT_TRANSPORT_BATCH
+}
+
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
@@ -31,6 +31,10 @@
 #    define RPC_S2M_BUFFER_SIZE 32
 #endif  // RPC_S2M_BUFFER_SIZE
 
+#ifndef SPLIT_TRANSPORT_BATCH_SIZE
+#    define SPLIT_TRANSPORT_BATCH_SIZE 32
+#endif  // SPLIT_TRANSPORT_BATCH_SIZE
+
 void transport_master_init(void);
 void transport_slave_init(void);
 
@@ -53,8 +57,20 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 #    include "rgblight.h"
 #endif  // RGBLIGHT_ENABLE
 
-typedef struct _split_slave_matrix_sync_t {
+#ifdef SPLIT_TRANSPORT_DELTA
+typedef struct _split_slave_matrix_delta_t {
     uint8_t      checksum;
+    uint8_t      row;
+    matrix_row_t row_data;
+} split_slave_matrix_delta_t;
+#endif  // SPLIT_TRANSPORT_DELTA
+
+typedef struct _split_slave_matrix_sync_t {
+#ifdef SPLIT_TRANSPORT_DELTA
+    split_slave_matrix_delta_t delta;
+#else   // SPLIT_TRANSPORT_DELTA
+    uint8_t checksum;
+#endif  // SPLIT_TRANSPORT_DELTA
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
 } split_slave_matrix_sync_t;
 
@@ -106,6 +122,15 @@ typedef struct _split_mods_sync_t {
 } split_mods_sync_t;
 #endif  // SPLIT_MODS_ENABLE
 
+#ifdef SPLIT_TRANSPORT_BATCH
+_Static_assert(SPLIT_TRANSPORT_BATCH_SIZE <= UINT8_MAX, "SPLIT_TRANSPORT_BATCH_SIZE must fit in a single byte");
+
+typedef struct _split_batch_sync_t {
+    uint8_t length;
+    uint8_t buffer[SPLIT_TRANSPORT_BATCH_SIZE];
+} split_batch_sync_t;
+#endif  // SPLIT_TRANSPORT_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 typedef struct _rpc_sync_info_t {
     int8_t  transaction_id;
@@ -173,6 +198,10 @@ typedef struct _split_shared_memory_t {
     uint8_t current_st7565_state;
 #endif  // ST7565_ENABLE(OLED_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_TRANSPORT_BATCH
+    split_batch_sync_t batch;
+#endif  // SPLIT_TRANSPORT_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
@@ -0,0 +1,156 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "eeprom_driver.h"
+#include "deferred_exec.h"
+#include "quantum.h"
+
+void advance_time(uint32_t ms);
+}
+
+#define TEST_BASE 128
+
+class EepromWriteBack : public TestFixture {
+   protected:
+    void SetUp() override {
+        eeprom_driver_flush();
+        eeprom_driver_erase();
+    }
+
+    /* Contents as seen by the underlying driver, bypassing any pending writes */
+    uint8_t stored_byte(uintptr_t addr) {
+        uint8_t value;
+        eeprom_driver_read_block(&value, (const void *)addr, 1);
+        return value;
+    }
+
+    void wait_ms(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advance_time(1);
+            deferred_exec_task();
+        }
+    }
+};
+
+TEST_F(EepromWriteBack, WritesAreDeferredUntilIdle) {
+    eeprom_update_byte((uint8_t *)TEST_BASE, 0x42);
+    EXPECT_EQ(eeprom_read_byte((uint8_t *)TEST_BASE), 0x42);
+    EXPECT_EQ(stored_byte(TEST_BASE), 0);
+
+    wait_ms(EEPROM_WRITE_BACK_TIMEOUT - 1);
+    EXPECT_EQ(stored_byte(TEST_BASE), 0);
+    wait_ms(1);
+    EXPECT_EQ(stored_byte(TEST_BASE), 0x42);
+}
+
+TEST_F(EepromWriteBack, RepeatedWritesExtendTimeout) {
+    for (uint8_t hue = 0; hue < 10; hue++) {
+        eeprom_update_byte((uint8_t *)TEST_BASE, hue + 1);
+        wait_ms(EEPROM_WRITE_BACK_TIMEOUT / 2);
+        EXPECT_EQ(stored_byte(TEST_BASE), 0);
+    }
+    EXPECT_EQ(eeprom_read_byte((uint8_t *)TEST_BASE), 10);
+    wait_ms(EEPROM_WRITE_BACK_TIMEOUT / 2);
+    EXPECT_EQ(stored_byte(TEST_BASE), 10);
+}
+
+TEST_F(EepromWriteBack, AdjacentWritesAreMerged) {
+    /* Both ends of a range, filled in from the middle outwards */
+    eeprom_update_word((uint16_t *)(TEST_BASE + 2), 0x0403);
+    eeprom_update_word((uint16_t *)(TEST_BASE + 4), 0x0605);
+    eeprom_update_word((uint16_t *)(TEST_BASE + 0), 0x0201);
+    eeprom_update_word((uint16_t *)(TEST_BASE + 6), 0x0807);
+    /* Another range elsewhere still fits */
+    eeprom_update_dword((uint32_t *)(TEST_BASE + 64), 0xdeadbeef);
+    for (uint8_t i = 0; i < 8; i++) {
+        EXPECT_EQ(stored_byte(TEST_BASE + i), 0);
+        EXPECT_EQ(eeprom_read_byte((uint8_t *)(TEST_BASE + i)), i + 1);
+    }
+    EXPECT_EQ(eeprom_read_dword((uint32_t *)(TEST_BASE + 64)), 0xdeadbeef);
+    EXPECT_EQ(stored_byte(TEST_BASE + 64), 0);
+
+    /* Overwrites within a range are absorbed */
+    eeprom_update_byte((uint8_t *)(TEST_BASE + 3), 0x33);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)(TEST_BASE + 2)), 0x3303);
+    EXPECT_EQ(stored_byte(TEST_BASE + 3), 0);
+
+    /* Running out of ranges writes everything pending */
+    eeprom_update_byte((uint8_t *)(TEST_BASE + 32), 0x99);
+    EXPECT_EQ(stored_byte(TEST_BASE + 0), 1);
+    EXPECT_EQ(stored_byte(TEST_BASE + 3), 0x33);
+    EXPECT_EQ(stored_byte(TEST_BASE + 7), 8);
+    EXPECT_EQ(stored_byte(TEST_BASE + 64), 0xef);
+    EXPECT_EQ(stored_byte(TEST_BASE + 32), 0);
+    EXPECT_EQ(eeprom_read_byte((uint8_t *)(TEST_BASE + 32)), 0x99);
+}
+
+TEST_F(EepromWriteBack, OverlappingRangesStayCoherent) {
+    eeprom_update_dword((uint32_t *)(TEST_BASE + 0), 0x04030201);
+    eeprom_update_dword((uint32_t *)(TEST_BASE + 8), 0x0c0b0a09);
+    /* Spans the end of one range and the start of the other */
+    eeprom_update_dword((uint32_t *)(TEST_BASE + 6), 0x44332211);
+    EXPECT_EQ(eeprom_read_dword((uint32_t *)(TEST_BASE + 4)), 0x22110000);
+    EXPECT_EQ(eeprom_read_dword((uint32_t *)(TEST_BASE + 8)), 0x0c0b4433);
+    eeprom_driver_flush();
+    EXPECT_EQ(stored_byte(TEST_BASE + 3), 0x04);
+    EXPECT_EQ(stored_byte(TEST_BASE + 6), 0x11);
+    EXPECT_EQ(stored_byte(TEST_BASE + 7), 0x22);
+    EXPECT_EQ(stored_byte(TEST_BASE + 8), 0x33);
+    EXPECT_EQ(stored_byte(TEST_BASE + 9), 0x44);
+    EXPECT_EQ(stored_byte(TEST_BASE + 10), 0x0b);
+}
+
+TEST_F(EepromWriteBack, BlockAccessSeesPendingWrites) {
+    uint8_t block[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    eeprom_update_word((uint16_t *)(TEST_BASE + 2), 0x2211);
+    eeprom_read_block(block, (const void *)TEST_BASE, sizeof(block));
+    EXPECT_EQ(block[1], 0);
+    EXPECT_EQ(block[2], 0x11);
+    EXPECT_EQ(block[3], 0x22);
+    EXPECT_EQ(block[4], 0);
+
+    /* A small block write is held back too, and updates the pending word */
+    block[3] = 0x33;
+    eeprom_write_block(block, (void *)TEST_BASE, sizeof(block));
+    EXPECT_EQ(stored_byte(TEST_BASE + 3), 0);
+    EXPECT_EQ(eeprom_read_word((uint16_t *)(TEST_BASE + 2)), 0x3311);
+    eeprom_driver_flush();
+    EXPECT_EQ(stored_byte(TEST_BASE + 3), 0x33);
+    EXPECT_EQ(stored_byte(TEST_BASE + 4), 0);
+}
+
+TEST_F(EepromWriteBack, LargeWritesGoStraightThrough) {
+    uint8_t block[EEPROM_WRITE_BACK_RANGE_SIZE * 2];
+    for (uint8_t i = 0; i < sizeof(block); i++) {
+        block[i] = i + 1;
+    }
+    eeprom_update_byte((uint8_t *)TEST_BASE, 0x42);
+    eeprom_update_block(block, (void *)(TEST_BASE + 1), sizeof(block));
+    EXPECT_EQ(stored_byte(TEST_BASE), 0x42);
+    EXPECT_EQ(stored_byte(TEST_BASE + 1), 1);
+    EXPECT_EQ(stored_byte(TEST_BASE + sizeof(block)), sizeof(block));
+}
+
+TEST_F(EepromWriteBack, SuspendFlushes) {
+    eeprom_update_byte((uint8_t *)TEST_BASE, 0x42);
+    EXPECT_EQ(stored_byte(TEST_BASE), 0);
+    suspend_power_down_quantum();
+    EXPECT_EQ(stored_byte(TEST_BASE), 0x42);
+}
@@ -0,0 +1,123 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::AtLeast;
+
+/* The ko_make_* initializers use designators out of declaration order, which C++ rejects. */
+static key_override_t make_override(uint8_t trigger_mods, uint16_t trigger, uint16_t replacement, ko_option_t options = ko_options_default) {
+    key_override_t override  = {};
+    override.trigger         = trigger;
+    override.trigger_mods    = trigger_mods;
+    override.layers          = ~0;
+    override.suppressed_mods = trigger_mods;
+    override.replacement     = replacement;
+    override.options         = options;
+    return override;
+}
+
+/* Listed ahead of the trigger-less override, so it must win for KC_B even though
+ * the KC_NO bucket sorts first in the index. */
+static const key_override_t b_override           = make_override(MOD_MASK_SHIFT, KC_B, KC_1);
+static const key_override_t bspc_override_first  = make_override(MOD_MASK_CTRL, KC_BSPC, KC_DEL);
+static const key_override_t bspc_override_second = make_override(MOD_MASK_CTRL, KC_BSPC, KC_2);
+/* Only needs shift, on any non-mod key down. */
+static const key_override_t shift_override = make_override(MOD_MASK_SHIFT, KC_NO, KC_4, ko_option_activation_trigger_down);
+static const key_override_t c_override     = make_override(MOD_MASK_SHIFT, KC_C, KC_3);
+
+static const key_override_t *test_key_overrides[] = {
+    &b_override, &bspc_override_first, &bspc_override_second, &shift_override, &c_override, NULL,
+};
+
+static const key_override_t *c_only_key_overrides[] = {
+    &c_override, NULL,
+};
+
+class KeyOverrideIndex : public TestFixture {
+   public:
+    KeyOverrideIndex() { key_overrides = test_key_overrides; }
+
+    /* Taps key while mod is held, and checks that the replacement is sent for it. */
+    void expect_replacement(TestDriver &driver, KeymapKey &mod, KeymapKey &key, uint16_t replacement) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(replacement))).Times(AtLeast(1));
+        mod.press();
+        run_one_scan_loop();
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+        mod.release();
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    }
+};
+
+TEST_F(KeyOverrideIndex, trigger_key_override) {
+    TestDriver driver;
+    auto       key_ctrl = KeymapKey(0, 0, 0, KC_LCTL);
+    auto       key_bspc = KeymapKey(0, 1, 0, KC_BSPC);
+
+    set_keymap({key_ctrl, key_bspc});
+
+    /* The first of two overrides with the same trigger wins. */
+    expect_replacement(driver, key_ctrl, key_bspc, KC_DEL);
+}
+
+TEST_F(KeyOverrideIndex, overrides_are_tried_in_listed_order) {
+    TestDriver driver;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LSFT);
+    auto       key_b     = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c     = KeymapKey(0, 2, 0, KC_C);
+
+    set_keymap({key_shift, key_b, key_c});
+
+    /* KC_B's override is listed before the trigger-less one, KC_C's after it. */
+    expect_replacement(driver, key_shift, key_b, KC_1);
+    expect_replacement(driver, key_shift, key_c, KC_4);
+}
+
+TEST_F(KeyOverrideIndex, trigger_less_override) {
+    TestDriver driver;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LSFT);
+    auto       key_a     = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({key_shift, key_a});
+
+    expect_replacement(driver, key_shift, key_a, KC_4);
+}
+
+TEST_F(KeyOverrideIndex, index_follows_key_overrides) {
+    TestDriver driver;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LSFT);
+    auto       key_c     = KeymapKey(0, 1, 0, KC_C);
+
+    set_keymap({key_shift, key_c});
+
+    expect_replacement(driver, key_shift, key_c, KC_4);
+
+    key_overrides = c_only_key_overrides;
+    expect_replacement(driver, key_shift, key_c, KC_3);
+}
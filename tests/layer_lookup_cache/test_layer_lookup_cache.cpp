@@ -0,0 +1,159 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class LayerLookupCache : public TestFixture {};
+
+TEST_F(LayerLookupCache, TransparentKeysFallThrough) {
+    TestDriver driver;
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+
+    set_keymap({regular_key, KeymapKey{1, 1, 0, KC_TRNS}, KeymapKey{2, 1, 0, KC_B}});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 0);
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 0);
+
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 2);
+
+    layer_off(2);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 0);
+
+    layer_clear();
+}
+
+TEST_F(LayerLookupCache, LayerBelowCachedLayerDoesNotShadowIt) {
+    TestDriver driver;
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+
+    set_keymap({regular_key, KeymapKey{1, 1, 0, KC_C}, KeymapKey{2, 1, 0, KC_B}});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 2);
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 2);
+
+    layer_off(2);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 1);
+
+    layer_clear();
+}
+
+TEST_F(LayerLookupCache, DefaultLayerChangeIsApplied) {
+    TestDriver driver;
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+
+    set_keymap({regular_key, KeymapKey{3, 1, 0, KC_B}});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 0);
+
+    default_layer_set(1 << 3);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 3);
+
+    default_layer_set(1 << 0);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 0);
+}
+
+TEST_F(LayerLookupCache, EepromResetClearsDefaultLayer) {
+    TestDriver driver;
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+
+    set_keymap({regular_key, KeymapKey{3, 1, 0, KC_B}});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    default_layer_set(1 << 3);
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 3);
+
+    eeconfig_init_quantum();
+    EXPECT_EQ(layer_switch_get_layer(regular_key.position), 0);
+
+    default_layer_set(1 << 0);
+}
+
+TEST_F(LayerLookupCache, KeymapChangeIsApplied) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+
+    set_keymap({regular_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    regular_key.press();
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    KeymapKey remapped_key = KeymapKey{0, 1, 0, KC_B};
+    set_keymap({remapped_key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    remapped_key.press();
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    remapped_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerLookupCache, MomentaryLayerWithKeypress) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  layer_key   = KeymapKey{0, 0, 0, MO(1)};
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+
+    set_keymap({layer_key, regular_key, KeymapKey{1, 1, 0, KC_B}});
+
+    /* Resolve the key on layer 0 first, so that it is cached. */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    regular_key.press();
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    regular_key.release();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    layer_key.press();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    regular_key.press();
+    run_one_scan_loop();
+
+    /* Releasing MO before the key must release the key pressed on layer 1. */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    layer_key.release();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,111 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "test_replay.hpp"
+
+class ReplayBenchmark : public TestFixture {
+   protected:
+    void SetUp() override {
+        for (uint8_t col = 0; col < 10; col++) {
+            add_key(KeymapKey(0, col, 0, KC_A + col));
+            add_key(KeymapKey(1, col, 0, KC_1 + col));
+        }
+        add_key(KeymapKey(0, 0, 1, LSFT_T(KC_K)));
+        add_key(KeymapKey(0, 1, 1, LCTL_T(KC_L)));
+        add_key(KeymapKey(0, 2, 1, LALT_T(KC_O)));
+        add_key(KeymapKey(0, 3, 1, LGUI_T(KC_W)));
+        add_key(KeymapKey(0, 0, 2, LT(1, KC_SPACE)));
+    }
+
+    /* Deterministic typing at roughly 100 wpm, with rollover between neighbouring keystrokes */
+    std::vector<ReplayEvent> synthetic_typing(size_t keystrokes) {
+        // Each key appears once, so overlapping presses are tracked per key; the last one (space) is typed twice as often
+        static const keypos_t keys[] = {
+            {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {8, 0}, {9, 0}, {0, 1}, {1, 1}, {2, 1}, {3, 1}, {0, 2},
+        };
+        static const uint8_t     weights[sizeof(keys) / sizeof(keys[0])] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2};
+        std::mt19937             rng(42);
+        std::vector<ReplayEvent> events;
+        uint32_t                 released[sizeof(keys) / sizeof(keys[0])] = {};
+        uint32_t                 time                                     = 0;
+        uint32_t                 total_weight                             = 0;
+        for (uint8_t weight : weights) {
+            total_weight += weight;
+        }
+
+        for (size_t i = 0; i < keystrokes; i++) {
+            size_t key;
+            do {
+                uint32_t pick = rng() % total_weight;
+                for (key = 0; pick >= weights[key]; key++) {
+                    pick -= weights[key];
+                }
+            } while (released[key] > time);
+
+            uint32_t hold = 50 + rng() % 70;
+            events.push_back({time, keys[key], true});
+            events.push_back({time + hold, keys[key], false});
+            released[key] = time + hold;
+            time += 60 + rng() % 120;
+        }
+
+        std::stable_sort(events.begin(), events.end(), [](const ReplayEvent& a, const ReplayEvent& b) { return a.time < b.time; });
+        return events;
+    }
+};
+
+TEST_F(ReplayBenchmark, recorded_trace) {
+    const char* path   = std::getenv("QMK_REPLAY_TRACE");
+    std::string folder = std::string(__FILE__).substr(0, std::string(__FILE__).find_last_of('/'));
+    auto        events = replay::load(path ? path : folder + "/typing.trace");
+    ASSERT_FALSE(events.empty());
+
+    auto stats = replay::run(events);
+    std::cout << stats;
+
+    EXPECT_EQ(stats.events, events.size());
+    EXPECT_GT(stats.reports, 0u);
+}
+
+TEST_F(ReplayBenchmark, synthetic_typing) {
+    auto events = synthetic_typing(5000);
+
+    /* Every event changes the state of its key, so none of them are no-ops */
+    std::set<std::pair<uint8_t, uint8_t>> down;
+    for (const auto& event : events) {
+        auto key = std::make_pair(event.position.row, event.position.col);
+        ASSERT_NE(down.count(key) == 1, event.pressed);
+        if (event.pressed) {
+            down.insert(key);
+        } else {
+            down.erase(key);
+        }
+    }
+
+    auto stats = replay::run(events);
+    std::cout << stats;
+
+    EXPECT_EQ(stats.events, events.size());
+    EXPECT_GT(stats.reports, 0u);
+}
@@ -0,0 +1,248 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "scan_profile.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InSequence;
+
+static uint32_t process_record_delay = 0;
+
+/* Simulate a slow handler, so the time spent processing the key shows up in the profile.
+ * KC_B is swallowed, so it stops the process_record_quantum() chain. */
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (record->event.pressed) {
+        advance_time(process_record_delay);
+    }
+    return keycode != KC_B;
+}
+
+class ScanProfile : public TestFixture {
+   public:
+    ScanProfile() {
+        process_record_delay = 0;
+        scan_profile_reset();
+    }
+};
+
+TEST_F(ScanProfile, records_one_sample_per_scan) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+
+    scan_profile_stats_t stats;
+    scan_profile_get(SCAN_PROFILE_KEYBOARD_TASK, &stats);
+    EXPECT_EQ(stats.count, 10);
+    scan_profile_get(SCAN_PROFILE_MATRIX_SCAN, &stats);
+    EXPECT_EQ(stats.count, 10);
+    scan_profile_get(SCAN_PROFILE_ACTION_EXEC, &stats);
+    EXPECT_EQ(stats.count, 10);
+    EXPECT_EQ(stats.max, 0);
+}
+
+TEST_F(ScanProfile, slow_key_processing_is_attributed_to_action_exec) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    process_record_delay = 5;
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key_a.press();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    run_one_scan_loop();
+
+    scan_profile_stats_t stats;
+    scan_profile_get(SCAN_PROFILE_ACTION_EXEC, &stats);
+    EXPECT_EQ(stats.count, 2);
+    EXPECT_EQ(stats.min, 0);
+    EXPECT_EQ(stats.max, 5);
+
+    scan_profile_get(SCAN_PROFILE_KEYBOARD_TASK, &stats);
+    EXPECT_EQ(stats.max, 5);
+
+    scan_profile_get(SCAN_PROFILE_MATRIX_SCAN, &stats);
+    EXPECT_EQ(stats.max, 0);
+}
+
+TEST_F(ScanProfile, p99_ignores_rare_outliers) {
+    for (int i = 0; i < 200; i++) {
+        scan_profile_record(SCAN_PROFILE_DEBOUNCE, 2);
+    }
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 1000);
+
+    scan_profile_stats_t stats;
+    scan_profile_get(SCAN_PROFILE_DEBOUNCE, &stats);
+    EXPECT_EQ(stats.count, 201);
+    EXPECT_EQ(stats.min, 2);
+    EXPECT_EQ(stats.max, 1000);
+    EXPECT_EQ(stats.p99, 3);
+}
+
+TEST_F(ScanProfile, reset_clears_statistics) {
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 7);
+    scan_profile_reset();
+
+    scan_profile_stats_t stats;
+    scan_profile_get(SCAN_PROFILE_DEBOUNCE, &stats);
+    EXPECT_EQ(stats.count, 0);
+    EXPECT_EQ(stats.max, 0);
+}
+
+TEST_F(ScanProfile, key_event_handlers_are_timed) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+
+    set_keymap({key_a, key_b});
+
+    process_record_delay = 3;
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key_a.press();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    run_one_scan_loop();
+
+    process_record_delay = 4;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    key_b.press();
+    run_one_scan_loop();
+    key_b.release();
+    run_one_scan_loop();
+
+    process_profile_stats_t stats;
+    process_profile_get(PROCESS_PROFILE_RECORD_KB, &stats);
+    EXPECT_EQ(stats.count, 4);
+    EXPECT_EQ(stats.stopped, 2);
+    EXPECT_EQ(stats.total, 7);
+    EXPECT_EQ(stats.max, 4);
+
+    scan_profile_reset();
+    process_profile_get(PROCESS_PROFILE_RECORD_KB, &stats);
+    EXPECT_EQ(stats.count, 0);
+    EXPECT_EQ(stats.total, 0);
+}
+
+TEST_F(ScanProfile, key_event_handler_totals_saturate) {
+    process_profile_record(PROCESS_PROFILE_RECORD_KB, UINT32_MAX - 1, true);
+    process_profile_record(PROCESS_PROFILE_RECORD_KB, 5, false);
+
+    process_profile_stats_t stats;
+    process_profile_get(PROCESS_PROFILE_RECORD_KB, &stats);
+    EXPECT_EQ(stats.count, 1);
+    EXPECT_EQ(stats.stopped, 0);
+    EXPECT_EQ(stats.total, UINT32_MAX - 1);
+}
+
+TEST_F(ScanProfile, handlers_only_see_their_keycode_range) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a    = KeymapKey(0, 0, 0, KC_A);
+    auto       key_gesc = KeymapKey(0, 1, 0, KC_GESC);
+
+    set_keymap({key_a, key_gesc});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key_a.press();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    run_one_scan_loop();
+
+    process_profile_stats_t stats;
+    process_profile_get(PROCESS_PROFILE_GRAVE_ESC, &stats);
+    EXPECT_EQ(stats.count, 0);
+
+    /* Space cadet acts on every key, so it is always called. */
+    process_profile_get(PROCESS_PROFILE_SPACE_CADET, &stats);
+    EXPECT_EQ(stats.count, 2);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    key_gesc.press();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_gesc.release();
+    run_one_scan_loop();
+
+    process_profile_get(PROCESS_PROFILE_GRAVE_ESC, &stats);
+    EXPECT_EQ(stats.count, 2);
+    EXPECT_EQ(stats.stopped, 2);
+
+    /* Space cadet comes earlier in the chain than grave escape. */
+    process_profile_get(PROCESS_PROFILE_SPACE_CADET, &stats);
+    EXPECT_EQ(stats.count, 4);
+}
+
+TEST_F(ScanProfile, statistics_are_readable_over_raw_hid) {
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 2);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 300);
+    process_profile_record(PROCESS_PROFILE_RECORD_KB, 4, false);
+
+    uint8_t data[32] = {0xFE, 0x00, SCAN_PROFILE_DEBOUNCE};
+    EXPECT_TRUE(scan_profile_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[3], SCAN_PROFILE_NUM_STAGES);
+    EXPECT_EQ(data[7], 2);   /* count */
+    EXPECT_EQ(data[11], 2);  /* min */
+    EXPECT_EQ(data[18], 300 >> 8);
+    EXPECT_EQ(data[19], 300 & 0xFF);
+
+    uint8_t handler[32] = {0xFE, 0x01, PROCESS_PROFILE_RECORD_KB};
+    EXPECT_TRUE(scan_profile_raw_hid_receive(handler, sizeof(handler)));
+    EXPECT_EQ(handler[3], PROCESS_PROFILE_NUM_HANDLERS);
+    EXPECT_EQ(handler[7], 1);   /* count */
+    EXPECT_EQ(handler[11], 1);  /* stopped */
+    EXPECT_EQ(handler[15], 4);  /* total */
+
+    uint8_t reset[32] = {0xFE, 0x02};
+    EXPECT_TRUE(scan_profile_raw_hid_receive(reset, sizeof(reset)));
+    scan_profile_stats_t stats;
+    scan_profile_get(SCAN_PROFILE_DEBOUNCE, &stats);
+    EXPECT_EQ(stats.count, 0);
+
+    uint8_t unknown[32] = {0xFE, 0x42};
+    EXPECT_TRUE(scan_profile_raw_hid_receive(unknown, sizeof(unknown)));
+    EXPECT_EQ(unknown[1], 0xFF);
+
+    uint8_t other[32] = {0x01};
+    EXPECT_FALSE(scan_profile_raw_hid_receive(other, sizeof(other)));
+    EXPECT_EQ(other[1], 0x00);
+}
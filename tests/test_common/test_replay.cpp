@@ -0,0 +1,134 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_replay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "gmock/gmock.h"
+#include "test_driver.hpp"
+#include "test_matrix.h"
+
+extern "C" {
+#include "timer.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InvokeWithoutArgs;
+
+std::ostream& operator<<(std::ostream& stream, const ReplayStats& stats) {
+    return stream << "Replayed " << stats.events << " events in " << stats.scans << " scans, " << stats.reports << " keyboard reports" << std::endl
+                  << "  " << stats.events_per_second << " events/s, " << stats.mean_event_ns << " ns/event, " << stats.max_scan_ns << " ns slowest scan" << std::endl
+                  << "  report latency " << stats.mean_latency_ms << " ms mean, " << stats.max_latency_ms << " ms max" << std::endl;
+}
+
+namespace replay {
+
+std::vector<ReplayEvent> parse(std::istream& trace) {
+    std::vector<ReplayEvent> events;
+    std::string              line;
+
+    while (std::getline(trace, line)) {
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        uint32_t           time;
+        unsigned           col, row;
+        char               action;
+        if (!(fields >> time >> col >> row >> action)) {
+            continue;
+        }
+        events.push_back({time, {.col = (uint8_t)col, .row = (uint8_t)row}, action == 'd'});
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const ReplayEvent& a, const ReplayEvent& b) { return a.time < b.time; });
+    return events;
+}
+
+std::vector<ReplayEvent> load(const std::string& path) {
+    std::ifstream trace(path);
+    return parse(trace);
+}
+
+ReplayStats run(const std::vector<ReplayEvent>& events, uint32_t settle_ms) {
+    using clock = std::chrono::steady_clock;
+
+    TestDriver  driver;
+    ReplayStats stats;
+    bool        pending       = false;
+    uint32_t    pending_since = 0;
+    uint64_t    latency_total = 0;
+    uint32_t    latencies     = 0;
+    double      task_ns       = 0;
+    double      event_scan_ns = 0;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(InvokeWithoutArgs([&]() {
+        stats.reports++;
+        if (pending) {
+            uint32_t latency     = timer_elapsed32(pending_since);
+            stats.max_latency_ms = std::max(stats.max_latency_ms, latency);
+            latency_total += latency;
+            latencies++;
+            pending = false;
+        }
+    }));
+
+    uint32_t end  = events.empty() ? 0 : events.back().time + settle_ms;
+    auto     next = events.begin();
+
+    for (uint32_t now = 0; now <= end; now++) {
+        size_t applied = 0;
+        for (; next != events.end() && next->time <= now; next++, applied++) {
+            if (next->pressed) {
+                press_key(next->position.col, next->position.row);
+            } else {
+                release_key(next->position.col, next->position.row);
+            }
+        }
+        if (applied && !pending) {
+            pending       = true;
+            pending_since = timer_read32();
+        }
+
+        auto before = clock::now();
+        keyboard_task();
+        double elapsed = std::chrono::duration<double, std::nano>(clock::now() - before).count();
+
+        task_ns += elapsed;
+        if (applied) {
+            event_scan_ns += elapsed;
+        }
+        stats.max_scan_ns = std::max(stats.max_scan_ns, elapsed);
+        stats.events += applied;
+        stats.scans++;
+        advance_time(1);
+    }
+
+    if (stats.events) {
+        stats.events_per_second = stats.events / (task_ns / 1e9);
+        stats.mean_event_ns     = event_scan_ns / stats.events;
+    }
+    if (latencies) {
+        stats.mean_latency_ms = (double)latency_total / latencies;
+    }
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    return stats;
+}
+
+}  // namespace replay
@@ -0,0 +1,60 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "keyboard.h"
+}
+
+/* One matrix change of a recorded keystroke trace */
+struct ReplayEvent {
+    uint32_t time; /* ms since the start of the trace */
+    keypos_t position;
+    bool     pressed;
+};
+
+struct ReplayStats {
+    size_t   events  = 0;
+    uint32_t scans   = 0;
+    uint32_t reports = 0;
+    /* Host CPU time spent in keyboard_task() */
+    double events_per_second = 0;
+    double mean_event_ns     = 0;
+    double max_scan_ns       = 0;
+    /* Simulated time from the oldest matrix change not yet followed by a keyboard report to that report */
+    double   mean_latency_ms = 0;
+    uint32_t max_latency_ms  = 0;
+};
+
+std::ostream& operator<<(std::ostream& stream, const ReplayStats& stats);
+
+namespace replay {
+/* Parses one "<time ms> <col> <row> <d|u>" event per line, '#' starts a comment */
+std::vector<ReplayEvent> parse(std::istream& trace);
+std::vector<ReplayEvent> load(const std::string& path);
+
+/* Feeds the trace to the test matrix, running one keyboard_task() per
+ * simulated millisecond, and keeps scanning for settle_ms after the last
+ * event so pending tap decisions are flushed. Installs its own TestDriver. */
+ReplayStats run(const std::vector<ReplayEvent>& events, uint32_t settle_ms = 1000);
+}  // namespace replay
@@ -97,6 +97,10 @@ void send_keyboard(report_keyboard_t *report) {
 #endif  // NKRO_ENABLE
 }
 
+#ifdef MOUSE_EXTENDED_REPORT
+#    error "MOUSE_EXTENDED_REPORT is not supported by the arm_atsam protocol"
+#endif
+
 void send_mouse(report_mouse_t *report) {
 #ifdef MOUSEKEY_ENABLE
     uint32_t irqflags;
@@ -464,6 +464,221 @@ void usb_event_queue_task(void) {
     }
 }
 
+/* ---------------------------------------------------------
+ *                  HID report queue
+ * ---------------------------------------------------------
+ */
+
+#ifdef USB_REPORT_QUEUE_ENABLE
+#    ifndef USB_REPORT_QUEUE_DEPTH
+#        define USB_REPORT_QUEUE_DEPTH 8
+#    endif
+
+#    if USB_REPORT_QUEUE_DEPTH < 2 || USB_REPORT_QUEUE_DEPTH > 255
+#        error "USB_REPORT_QUEUE_DEPTH must be between 2 and 255"
+#    endif
+
+typedef union {
+    report_keyboard_t  keyboard;
+    report_mouse_t     mouse;
+    report_extra_t     extra;
+    report_digitizer_t digitizer;
+} usb_report_t;
+
+typedef struct {
+    /* copy of the bytes handed to usbStartTransmitI, which keeps using them until the IN callback */
+    uint8_t data[sizeof(usb_report_t)] __attribute__((aligned(4)));
+    uint8_t size;
+    uint8_t report_id;
+} usb_queued_report_t;
+
+typedef struct {
+    usbep_t                  ep;
+    bool                     in_flight; /* slots[head] is being transmitted */
+    uint8_t                  head;
+    uint8_t                  count;
+    usb_report_queue_stats_t stats;
+    usb_queued_report_t      slots[USB_REPORT_QUEUE_DEPTH];
+} usb_report_queue_t;
+
+#    ifndef KEYBOARD_SHARED_EP
+static usb_report_queue_t kbd_report_queue = {.ep = KEYBOARD_IN_EPNUM};
+#    endif
+#    if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static usb_report_queue_t mouse_report_queue = {.ep = MOUSE_IN_EPNUM};
+#    endif
+#    ifdef SHARED_EP_ENABLE
+static usb_report_queue_t shared_report_queue = {.ep = SHARED_IN_EPNUM};
+#    endif
+
+static usb_report_queue_t *usb_report_queue_get(usbep_t ep) {
+#    ifndef KEYBOARD_SHARED_EP
+    if (ep == KEYBOARD_IN_EPNUM) {
+        return &kbd_report_queue;
+    }
+#    endif
+#    if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    if (ep == MOUSE_IN_EPNUM) {
+        return &mouse_report_queue;
+    }
+#    endif
+#    ifdef SHARED_EP_ENABLE
+    if (ep == SHARED_IN_EPNUM) {
+        return &shared_report_queue;
+    }
+#    endif
+    return NULL;
+}
+
+/* Drop everything queued, the endpoints have just been (re)initialised */
+static void usb_report_queue_reset_i(void) {
+    for (usbep_t ep = 1; ep <= USB_MAX_ENDPOINTS; ep++) {
+        usb_report_queue_t *queue = usb_report_queue_get(ep);
+        if (queue != NULL) {
+            queue->in_flight = false;
+            queue->head      = 0;
+            queue->count     = 0;
+        }
+    }
+}
+
+/* Start transmitting the oldest queued report if the endpoint is idle */
+static void usb_report_queue_start_i(usb_report_queue_t *queue) {
+    if (queue->count == 0 || usbGetTransmitStatusI(&USB_DRIVER, queue->ep)) {
+        return;
+    }
+    usb_queued_report_t *slot = &queue->slots[queue->head];
+    queue->in_flight          = true;
+    usbStartTransmitI(&USB_DRIVER, queue->ep, slot->data, slot->size);
+}
+
+/* IN-complete handler, releases the slot that was sent and feeds the next one */
+static void usb_report_queue_in_cb(USBDriver *usbp, usbep_t ep) {
+    (void)usbp;
+    usb_report_queue_t *queue = usb_report_queue_get(ep);
+    if (queue == NULL) {
+        return;
+    }
+
+    osalSysLockFromISR();
+    if (queue->in_flight) {
+        queue->in_flight = false;
+        queue->head      = (queue->head + 1) % USB_REPORT_QUEUE_DEPTH;
+        queue->count--;
+    }
+    usb_report_queue_start_i(queue);
+    osalSysUnlockFromISR();
+}
+
+#    ifdef MOUSE_ENABLE
+/* Fold the motion of a mouse report into one still waiting, if nothing overflows */
+static bool usb_report_merge_mouse(report_mouse_t *queued, const report_mouse_t *report) {
+    int32_t x = queued->x + report->x;
+    int32_t y = queued->y + report->y;
+    int16_t v = queued->v + report->v;
+    int16_t h = queued->h + report->h;
+
+    if (queued->buttons != report->buttons || x < MOUSE_REPORT_XY_MIN || x > MOUSE_REPORT_XY_MAX || y < MOUSE_REPORT_XY_MIN || y > MOUSE_REPORT_XY_MAX || v < -127 || v > 127 || h < -127 || h > 127) {
+        return false;
+    }
+
+    queued->x = x;
+    queued->y = y;
+    queued->v = v;
+    queued->h = h;
+    return true;
+}
+#    endif
+
+/* Queue a report behind whatever the endpoint is already sending.
+ * Only reports that leave the host in the same state are folded: a repeat of
+ * the newest queued report with the same id is skipped, and mouse motion is
+ * summed into the newest waiting report while the buttons match. Anything
+ * else waits for a free slot, as the unqueued path waits for the endpoint,
+ * so a key state is never replaced before the host has seen it.
+ * Called with the system locked, not callable from ISR. */
+static void usb_report_queue_push_s(usbep_t ep, uint8_t report_id, const void *data, uint8_t size) {
+    usb_report_queue_t *queue = usb_report_queue_get(ep);
+    if (queue == NULL) {
+        return;
+    }
+
+    usb_queued_report_t *newest = NULL;
+    for (uint8_t i = queue->count; i > 0; i--) {
+        usb_queued_report_t *slot = &queue->slots[(queue->head + i - 1) % USB_REPORT_QUEUE_DEPTH];
+        if (slot->report_id == report_id) {
+            newest = slot;
+            break;
+        }
+    }
+
+    bool relative = false;
+#    ifdef MOUSE_ENABLE
+    /* the slot at head is the one being transmitted */
+    bool waiting = newest != NULL && !(newest == &queue->slots[queue->head] && queue->in_flight);
+    relative     = report_id == REPORT_ID_MOUSE;
+    if (relative && waiting && usb_report_merge_mouse((report_mouse_t *)newest->data, (const report_mouse_t *)data)) {
+        queue->stats.coalesced++;
+        return;
+    }
+#    endif
+    if (!relative && newest != NULL && newest->size == size && memcmp(newest->data, data, size) == 0) {
+        return;
+    }
+
+    while (queue->count == USB_REPORT_QUEUE_DEPTH) {
+        if (osalThreadSuspendTimeoutS(&USB_DRIVER.epc[ep]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT || usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+            queue->stats.dropped++;
+            return;
+        }
+    }
+
+    usb_queued_report_t *slot = &queue->slots[(queue->head + queue->count) % USB_REPORT_QUEUE_DEPTH];
+    queue->count++;
+
+    memcpy(slot->data, data, size);
+    slot->size      = size;
+    slot->report_id = report_id;
+    if (queue->count > queue->stats.max_depth) {
+        queue->stats.max_depth = queue->count;
+    }
+    usb_report_queue_start_i(queue);
+}
+
+bool usb_report_queue_get_stats(usbep_t ep, usb_report_queue_stats_t *stats) {
+    usb_report_queue_t *queue = usb_report_queue_get(ep);
+    if (queue == NULL) {
+        return false;
+    }
+
+    osalSysLock();
+    *stats       = queue->stats;
+    stats->depth = queue->count;
+    osalSysUnlock();
+    return true;
+}
+
+/* Packed send_string output waits here for a free keyboard slot, so it does
+ * not have to wait inside the report push */
+void send_string_wait_for_host(void) {
+    usbep_t ep = KEYBOARD_IN_EPNUM;
+#    ifdef NKRO_ENABLE
+    if (keymap_config.nkro && keyboard_protocol) {
+        ep = SHARED_IN_EPNUM;
+    }
+#    endif
+    usb_report_queue_t *queue = usb_report_queue_get(ep);
+
+    osalSysLock();
+    while (usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE && queue->count == USB_REPORT_QUEUE_DEPTH) {
+        if (osalThreadSuspendTimeoutS(&USB_DRIVER.epc[ep]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
+            break;
+        }
+    }
+    osalSysUnlock();
+}
+#endif /* USB_REPORT_QUEUE_ENABLE */
+
 /* Handles the USB driver global events
  * TODO: maybe disable some things when connection is lost? */
 static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
@@ -482,6 +697,9 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 #endif
 #ifdef SHARED_EP_ENABLE
             usbInitEndpointI(usbp, SHARED_IN_EPNUM, &shared_ep_config);
+#endif
+#ifdef USB_REPORT_QUEUE_ENABLE
+            usb_report_queue_reset_i();
 #endif
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
 #if STM32_USB_USE_OTG1
@@ -766,9 +984,13 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
+#    ifdef USB_REPORT_QUEUE_ENABLE
+    usb_report_queue_in_cb(usbp, ep);
+#    else
     /* STUB */
     (void)usbp;
     (void)ep;
+#    endif
 }
 #endif
 
@@ -827,6 +1049,10 @@ void send_keyboard(report_keyboard_t *report) {
 
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
+#    ifdef USB_REPORT_QUEUE_ENABLE
+        usb_report_queue_push_s(SHARED_IN_EPNUM, REPORT_ID_NKRO, report, sizeof(struct nkro_report));
+    } else
+#    else
         /* need to wait until the previous packet has made it through */
         /* can rewrite this using the synchronous API, then would wait
          * until *after* the packet has been transmitted. I think
@@ -846,8 +1072,10 @@ void send_keyboard(report_keyboard_t *report) {
         }
         usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
     } else
+#    endif
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
+#ifndef USB_REPORT_QUEUE_ENABLE
         /* need to wait until the previous packet has made it through */
         /* busy wait, should be short and not very common */
         if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
@@ -862,6 +1090,7 @@ void send_keyboard(report_keyboard_t *report) {
                 goto unlock;
             }
         }
+#endif
         uint8_t *data, size;
         if (keyboard_protocol) {
             data = (uint8_t *)report;
@@ -870,7 +1099,11 @@ void send_keyboard(report_keyboard_t *report) {
             data = &report->mods;
             size = 8;
         }
+#ifdef USB_REPORT_QUEUE_ENABLE
+        usb_report_queue_push_s(KEYBOARD_IN_EPNUM, REPORT_ID_KEYBOARD, data, size);
+#else
         usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
+#endif
     }
     keyboard_report_sent = *report;
 
@@ -888,8 +1121,12 @@ unlock:
 #    ifndef MOUSE_SHARED_EP
 /* mouse IN callback hander (a mouse report has made it IN) */
 void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
+#        ifdef USB_REPORT_QUEUE_ENABLE
+    usb_report_queue_in_cb(usbp, ep);
+#        else
     (void)usbp;
     (void)ep;
+#        endif
 }
 #    endif
 
@@ -900,6 +1137,9 @@ void send_mouse(report_mouse_t *report) {
         return;
     }
 
+#    ifdef USB_REPORT_QUEUE_ENABLE
+    usb_report_queue_push_s(MOUSE_IN_EPNUM, REPORT_ID_MOUSE, report, sizeof(report_mouse_t));
+#    else
     if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
         /* Need to either suspend, or loop and call unlock/lock during
          * every iteration - otherwise the system will remain locked,
@@ -911,6 +1151,7 @@ void send_mouse(report_mouse_t *report) {
         }
     }
     usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
+#    endif
     osalSysUnlock();
 }
 
@@ -925,9 +1166,13 @@ void send_mouse(report_mouse_t *report) { (void)report; }
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
+#    ifdef USB_REPORT_QUEUE_ENABLE
+    usb_report_queue_in_cb(usbp, ep);
+#    else
     /* STUB */
     (void)usbp;
     (void)ep;
+#    endif
 }
 #endif
 
@@ -944,6 +1189,10 @@ static void send_extra(uint8_t report_id, uint16_t data) {
         return;
     }
 
+#    ifdef USB_REPORT_QUEUE_ENABLE
+    report_extra_t report = {.report_id = report_id, .usage = data};
+    usb_report_queue_push_s(SHARED_IN_EPNUM, report_id, &report, sizeof(report_extra_t));
+#    else
     if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
         /* Need to either suspend, or loop and call unlock/lock during
          * every iteration - otherwise the system will remain locked,
@@ -959,6 +1208,7 @@ static void send_extra(uint8_t report_id, uint16_t data) {
     report = (report_extra_t){.report_id = report_id, .usage = data};
 
     usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
+#    endif
     osalSysUnlock();
 }
 #endif
@@ -984,7 +1234,11 @@ void send_digitizer(report_digitizer_t *report) {
         return;
     }
 
+#        ifdef USB_REPORT_QUEUE_ENABLE
+    usb_report_queue_push_s(DIGITIZER_IN_EPNUM, REPORT_ID_DIGITIZER, report, sizeof(report_digitizer_t));
+#        else
     usbStartTransmitI(&USB_DRIVER, DIGITIZER_IN_EPNUM, (uint8_t *)report, sizeof(report_digitizer_t));
+#        endif
     osalSysUnlock();
 #    else
     chnWrite(&drivers.digitizer_driver.driver, (uint8_t *)report, sizeof(report_digitizer_t));
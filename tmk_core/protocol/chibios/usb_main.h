@@ -48,6 +48,23 @@ void usb_event_queue_init(void);
 /* Task to dequeue and execute any handlers for the USB events on the main thread */
 void usb_event_queue_task(void);
 
+#ifdef USB_REPORT_QUEUE_ENABLE
+/* ----------------
+ * HID report queue
+ * ----------------
+ */
+
+typedef struct {
+    uint8_t  depth;     /* reports queued, including the one being sent */
+    uint8_t  max_depth; /* highest depth seen */
+    uint16_t coalesced; /* mouse reports folded into one still queued */
+    uint16_t dropped;   /* reports discarded on wait timeout or while USB is inactive */
+} usb_report_queue_stats_t;
+
+/* Read the report queue counters of an IN endpoint, false if it has no queue */
+bool usb_report_queue_get_stats(usbep_t ep, usb_report_queue_stats_t *stats);
+#endif
+
 /* ---------------
  * Keyboard header
  * ---------------
@@ -738,16 +738,19 @@ static void send_mouse(report_mouse_t *report) {
 
 #    ifdef BLUETOOTH_ENABLE
     if (where_to_send() == OUTPUT_BLUETOOTH) {
+        // the bluetooth modules only take 8 bit motion
+        int8_t x = report->x < -127 ? -127 : (report->x > 127 ? 127 : report->x);
+        int8_t y = report->y < -127 ? -127 : (report->y > 127 ? 127 : report->y);
 #        ifdef MODULE_ADAFRUIT_BLE
         // FIXME: mouse buttons
-        adafruit_ble_send_mouse_move(report->x, report->y, report->v, report->h, report->buttons);
+        adafruit_ble_send_mouse_move(x, y, report->v, report->h, report->buttons);
 #        else
         serial_send(0xFD);
         serial_send(0x00);
         serial_send(0x03);
         serial_send(report->buttons);
-        serial_send(report->x);
-        serial_send(report->y);
+        serial_send(x);
+        serial_send(y);
         serial_send(report->v);  // should try sending the wheel v here
         serial_send(report->h);  // should try sending the wheel h here
         serial_send(0x00);
@@ -31,11 +31,81 @@ static int8_t cb_tail  = 0;
 static int8_t cb_count = 0;
 #endif
 
+#ifdef KEYBOARD_REPORT_SLOT_MAP
+#    if KEYBOARD_REPORT_KEYS > 8
+#        error KEYBOARD_REPORT_SLOT_MAP supports at most 8 report keys
+#    endif
+#    define SLOT_MAP_FULL ((1 << KEYBOARD_REPORT_KEYS) - 1)
+
+/* Slot + 1 of each keycode in the 6KRO report, two keycodes per byte, 0 when
+ * absent. It follows one report at a time, which must only be changed through
+ * the functions below. */
+static uint8_t            slot_map[128];
+static uint8_t            slot_used       = 0;
+static report_keyboard_t* slot_map_report = NULL;
+
+static uint8_t slot_map_get(uint8_t code) { return (slot_map[code >> 1] >> ((code & 1) << 2)) & 0x0F; }
+
+static void slot_map_set(uint8_t code, uint8_t value) {
+    uint8_t shift       = (code & 1) << 2;
+    slot_map[code >> 1] = (slot_map[code >> 1] & ~(0x0F << shift)) | (value << shift);
+}
+
+/** \brief Fill a slot and record it in the map
+ */
+static void slot_map_take(report_keyboard_t* keyboard_report, uint8_t slot, uint8_t code) {
+    keyboard_report->keys[slot] = code;
+    slot_map_set(code, slot + 1);
+    slot_used |= 1 << slot;
+}
+
+/** \brief Empty a slot and forget it in the map
+ */
+static void slot_map_release(report_keyboard_t* keyboard_report, uint8_t slot) {
+    slot_map_set(keyboard_report->keys[slot], 0);
+    keyboard_report->keys[slot] = 0;
+    slot_used &= ~(1 << slot);
+}
+
+/** \brief Find the slot holding a keycode
+ *
+ * Switching to another report rebuilds the map from its contents first.
+ * Returns the slot, or -1 when the keycode is not in the report.
+ */
+static int8_t slot_map_find(report_keyboard_t* keyboard_report, uint8_t code) {
+    if (keyboard_report != slot_map_report) {
+        memset(slot_map, 0, sizeof(slot_map));
+        slot_used       = 0;
+        slot_map_report = keyboard_report;
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (keyboard_report->keys[i]) {
+                slot_map_take(keyboard_report, i, keyboard_report->keys[i]);
+            }
+        }
+    }
+
+    uint8_t slot = slot_map_get(code);
+    if (code != KC_NO && slot && keyboard_report->keys[slot - 1] == code) {
+        return slot - 1;
+    }
+    return -1;
+}
+#endif
+
 /** \brief has_anykey
  *
  * FIXME: Needs doc
  */
 uint8_t has_anykey(report_keyboard_t* keyboard_report) {
+#ifdef KEYBOARD_REPORT_SLOT_MAP
+#    ifdef NKRO_ENABLE
+    if (!(keyboard_protocol && keymap_config.nkro))
+#    endif
+    {
+        slot_map_find(keyboard_report, KC_NO);
+        return bitpop(slot_used);
+    }
+#endif
     uint8_t  cnt = 0;
     uint8_t* p   = keyboard_report->keys;
     uint8_t  lp  = sizeof(keyboard_report->keys);
@@ -96,12 +166,16 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
         }
     }
 #endif
+#ifdef KEYBOARD_REPORT_SLOT_MAP
+    return slot_map_find(keyboard_report, key) >= 0;
+#else
     for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
         if (keyboard_report->keys[i] == key) {
             return true;
         }
     }
     return false;
+#endif
 }
 
 /** \brief add key byte
@@ -109,10 +183,25 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
  * FIXME: Needs doc
  */
 void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
+#ifdef KEYBOARD_REPORT_SLOT_MAP
+    if (code == KC_NO || slot_map_find(keyboard_report, code) >= 0) {
+        return;
+    }
+#endif
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
     int8_t i     = cb_head;
     int8_t empty = -1;
     if (cb_count) {
+#    ifdef KEYBOARD_REPORT_SLOT_MAP
+        // no duplicate to look for, only a full buffer needs its first empty slot
+        if (cb_tail == cb_head && slot_used != SLOT_MAP_FULL) {
+            while (keyboard_report->keys[i] != 0) {
+                i = RO_INC(i);
+            }
+            empty = i;
+        }
+        i = cb_tail;
+#    else
         do {
             if (keyboard_report->keys[i] == code) {
                 return;
@@ -122,11 +211,15 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
             }
             i = RO_INC(i);
         } while (i != cb_tail);
+#    endif
         if (i == cb_tail) {
             if (cb_tail == cb_head) {
                 // buffer is full
                 if (empty == -1) {
                     // pop head when has no empty space
+#    ifdef KEYBOARD_REPORT_SLOT_MAP
+                    slot_map_release(keyboard_report, cb_head);
+#    endif
                     cb_head = RO_INC(cb_head);
                     cb_count--;
                 } else {
@@ -135,9 +228,15 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
                     i              = RO_INC(empty);
                     do {
                         if (keyboard_report->keys[i] != 0) {
+#    ifdef KEYBOARD_REPORT_SLOT_MAP
+                            uint8_t moved = keyboard_report->keys[i];
+                            slot_map_release(keyboard_report, i);
+                            slot_map_take(keyboard_report, empty, moved);
+#    else
                             keyboard_report->keys[empty] = keyboard_report->keys[i];
                             keyboard_report->keys[i]     = 0;
-                            empty                        = RO_INC(empty);
+#    endif
+                            empty = RO_INC(empty);
                         } else {
                             offset++;
                         }
@@ -149,9 +248,19 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
         }
     }
     // add to tail
+#    ifdef KEYBOARD_REPORT_SLOT_MAP
+    slot_map_take(keyboard_report, cb_tail, code);
+#    else
     keyboard_report->keys[cb_tail] = code;
-    cb_tail                        = RO_INC(cb_tail);
+#    endif
+    cb_tail = RO_INC(cb_tail);
     cb_count++;
+#elif defined(KEYBOARD_REPORT_SLOT_MAP)
+    uint8_t free = ~slot_used & SLOT_MAP_FULL;
+    if (free) {
+        // lowest empty slot, as the scan below would pick
+        slot_map_take(keyboard_report, biton(free & -free), code);
+    }
 #else
     int8_t i     = 0;
     int8_t empty = -1;
@@ -177,29 +286,43 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
  */
 void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
 #ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+#    ifdef KEYBOARD_REPORT_SLOT_MAP
+    int8_t i = slot_map_find(keyboard_report, code);
+    if (i < 0) {
+        return;
+    }
+    slot_map_release(keyboard_report, i);
+#    else
     uint8_t i = cb_head;
-    if (cb_count) {
+    if (!cb_count) {
+        return;
+    }
+    while (keyboard_report->keys[i] != code) {
+        i = RO_INC(i);
+        if (i == cb_tail) {
+            return;
+        }
+    }
+    keyboard_report->keys[i] = 0;
+#    endif
+    cb_count--;
+    if (cb_count == 0) {
+        // reset head and tail
+        cb_tail = cb_head = 0;
+    }
+    if (i == RO_DEC(cb_tail)) {
+        // left shift when next to tail
         do {
-            if (keyboard_report->keys[i] == code) {
-                keyboard_report->keys[i] = 0;
-                cb_count--;
-                if (cb_count == 0) {
-                    // reset head and tail
-                    cb_tail = cb_head = 0;
-                }
-                if (i == RO_DEC(cb_tail)) {
-                    // left shift when next to tail
-                    do {
-                        cb_tail = RO_DEC(cb_tail);
-                        if (keyboard_report->keys[RO_DEC(cb_tail)] != 0) {
-                            break;
-                        }
-                    } while (cb_tail != cb_head);
-                }
+            cb_tail = RO_DEC(cb_tail);
+            if (keyboard_report->keys[RO_DEC(cb_tail)] != 0) {
                 break;
             }
-            i = RO_INC(i);
-        } while (i != cb_tail);
+        } while (cb_tail != cb_head);
+    }
+#elif defined(KEYBOARD_REPORT_SLOT_MAP)
+    int8_t i = slot_map_find(keyboard_report, code);
+    if (i >= 0) {
+        slot_map_release(keyboard_report, i);
     }
 #else
     for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
@@ -275,6 +398,20 @@ void clear_keys_from_report(report_keyboard_t* keyboard_report) {
         memset(keyboard_report->nkro.bits, 0, sizeof(keyboard_report->nkro.bits));
         return;
     }
+#endif
+#ifdef KEYBOARD_REPORT_SLOT_MAP
+    if (keyboard_report == slot_map_report) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (slot_used & (1 << i)) {
+                slot_map_release(keyboard_report, i);
+            }
+        }
+    }
 #endif
     memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+    cb_head  = 0;
+    cb_tail  = 0;
+    cb_count = 0;
+#endif
 }